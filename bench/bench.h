@@ -0,0 +1,243 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+// minimal micro-benchmark harness. every case is a function that runs its
+// body `n` times; the runner calibrates n so one sample takes about
+// `sampleSeconds`, runs `warmup` samples it throws away and then records
+// `repetitions` samples.
+
+// keep the optimizer from deleting benchmark results
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct BenchCase {
+    std::string name;
+    double itemsPerIter = 1.0;
+    std::function<void(size_t)> run;
+};
+
+struct BenchResult {
+    std::string name;
+    double itemsPerIter = 1.0;
+    size_t iterations = 0;          // per sample
+    std::vector<double> samples;    // ns per iteration
+
+    double min = 0, median = 0, mean = 0, stddev = 0, p90 = 0;
+
+    double itemsPerSecond() const {
+        return median > 0 ? itemsPerIter * 1e9 / median : 0.0;
+    }
+};
+
+class BenchRunner {
+public:
+    int warmup = 2;
+    int repetitions = 10;
+    double sampleSeconds = 0.05;
+    std::string filter;
+
+    std::vector<BenchResult> results;
+
+    void add(const std::string& name, double itemsPerIter, std::function<void(size_t)> fn) {
+        BenchCase c;
+        c.name = name;
+        c.itemsPerIter = itemsPerIter;
+        c.run = fn;
+        cases.push_back(c);
+    }
+
+    void runAll() {
+        std::cout << std::left << std::setw(40) << "benchmark" << std::right
+                  << std::setw(14) << "median ns" << std::setw(10) << "+/-%"
+                  << std::setw(14) << "min ns" << std::setw(14) << "p90 ns"
+                  << std::setw(16) << "items/s" << "\n";
+
+        for (const BenchCase& c : cases) {
+            if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+
+            BenchResult r = run(c);
+            results.push_back(r);
+
+            std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(14) << r.median
+                      << std::setw(10) << (r.mean > 0 ? r.stddev / r.mean * 100.0 : 0.0)
+                      << std::setw(14) << r.min << std::setw(14) << r.p90
+                      << std::setw(16) << std::scientific << std::setprecision(3)
+                      << r.itemsPerSecond() << std::defaultfloat << "\n";
+        }
+    }
+
+    // one benchmark per line so two runs diff cleanly
+    bool writeJson(const std::string& path) const {
+        std::ofstream f(path);
+        if (!f.is_open()) {
+            std::cerr << "cannot write " << path << std::endl;
+            return false;
+        }
+
+        char date[32];
+        time_t now = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+        f << "{\n";
+        f << "  \"context\": {\"date\": \"" << date << "\", \"compiler\": \"" << compiler()
+          << "\", \"repetitions\": " << repetitions << ", \"warmup\": " << warmup
+          << ", \"sample_seconds\": " << sampleSeconds << "},\n";
+        f << "  \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            f << std::setprecision(6)
+              << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+              << ", \"items_per_iter\": " << r.itemsPerIter
+              << ", \"ns_min\": " << r.min << ", \"ns_median\": " << r.median
+              << ", \"ns_mean\": " << r.mean << ", \"ns_stddev\": " << r.stddev
+              << ", \"ns_p90\": " << r.p90
+              << ", \"items_per_second\": " << r.itemsPerSecond() << "}"
+              << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        f << "  ]\n}\n";
+        return true;
+    }
+
+    // print median deltas against a previous writeJson() file
+    void compare(const std::string& path) const {
+        std::ifstream f(path);
+        if (!f.is_open()) {
+            std::cerr << "cannot read " << path << std::endl;
+            return;
+        }
+
+        std::cout << "\ncompared to " << path << " (median, negative is faster)\n";
+
+        std::string line;
+        while (std::getline(f, line)) {
+            std::string name = field(line, "\"name\": \"", "\"");
+            std::string median = field(line, "\"ns_median\": ", ",");
+            if (name.empty() || median.empty()) continue;
+
+            double old = atof(median.c_str());
+            for (const BenchResult& r : results) {
+                if (r.name != name || old <= 0) continue;
+                std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+                          << std::setprecision(1) << std::setw(10)
+                          << (r.median - old) / old * 100.0 << " %\n" << std::defaultfloat;
+            }
+        }
+    }
+
+private:
+    std::vector<BenchCase> cases;
+
+    typedef std::chrono::steady_clock Clock;
+
+    static double timeIt(const BenchCase& c, size_t n) {
+        Clock::time_point t0 = Clock::now();
+        c.run(n);
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    BenchResult run(const BenchCase& c) const {
+        BenchResult r;
+        r.name = c.name;
+        r.itemsPerIter = c.itemsPerIter;
+
+        // grow n until a sample is long enough to time reliably
+        size_t n = 1;
+        double t = timeIt(c, n);
+        while (t < sampleSeconds / 10 && n < (size_t(1) << 40)) {
+            n *= t > 0 ? std::min<size_t>(100, std::max<size_t>(2, (size_t)(sampleSeconds / 10 / t))) : 100;
+            t = timeIt(c, n);
+        }
+        if (t > 0) n = std::max<size_t>(1, (size_t)(n * sampleSeconds / t));
+        r.iterations = n;
+
+        for (int i = 0; i < warmup; i++) timeIt(c, n);
+
+        for (int i = 0; i < repetitions; i++) {
+            r.samples.push_back(timeIt(c, n) * 1e9 / n);
+        }
+
+        std::vector<double> s = r.samples;
+        std::sort(s.begin(), s.end());
+
+        double sum = 0;
+        for (double v : s) sum += v;
+        r.mean = sum / s.size();
+
+        double var = 0;
+        for (double v : s) var += (v - r.mean) * (v - r.mean);
+        r.stddev = s.size() > 1 ? std::sqrt(var / (s.size() - 1)) : 0.0;
+
+        r.min = s.front();
+        r.median = s.size() % 2 ? s[s.size() / 2] : (s[s.size() / 2 - 1] + s[s.size() / 2]) * 0.5;
+        r.p90 = s[std::min(s.size() - 1, (size_t)std::ceil(0.9 * s.size()) - 1)];
+        return r;
+    }
+
+    static std::string field(const std::string& line, const char* key, const char* end) {
+        size_t a = line.find(key);
+        if (a == std::string::npos) return "";
+        a += strlen(key);
+        size_t b = line.find(end, a);
+        return b == std::string::npos ? "" : line.substr(a, b - a);
+    }
+
+    static std::string compiler() {
+        std::stringstream ss;
+#if defined(__clang__)
+        ss << "clang " << __clang_major__ << "." << __clang_minor__;
+#elif defined(__GNUC__)
+        ss << "gcc " << __GNUC__ << "." << __GNUC_MINOR__;
+#elif defined(_MSC_VER)
+        ss << "msvc " << _MSC_VER;
+#else
+        ss << "unknown";
+#endif
+#ifdef NDEBUG
+        ss << " release";
+#endif
+        return ss.str();
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,668 @@
+// togl_bench: CPU micro-benchmarks for the loader, math, scene graph,
+// animation, shader uniform, logging and console hot paths. needs no window or GL context; GL entry
+// points the code under test calls are replaced with no-op stubs.
+//
+// the frame/ cases also check that a warmed-up headless frame makes no
+// heap allocations; the exit code is 1 if it does.
+//
+// usage: togl_bench [--filter substr] [--reps N] [--warmup N]
+//                   [--json out.json] [--compare old.json]
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+
+#include "shader.h"
+#include "camera.h"
+#include "model.h"
+#include "log.h"
+#include "console.h"
+#include "profiler.h"
+#include "arena.h"
+#include "newhook.h"
+
+#include "bench.h"
+
+#include <stb/stb_image_write.h>
+
+// GL stubs: the shader benchmarks measure our wrapper overhead, not a driver
+static GLuint APIENTRY StubCreate(GLenum) { return 1; }
+static GLuint APIENTRY StubCreateProgram() { return 1; }
+static void APIENTRY StubShaderSource(GLuint, GLsizei, const GLchar* const*, const GLint*) {}
+static void APIENTRY StubUint(GLuint) {}
+static void APIENTRY StubUint2(GLuint, GLuint) {}
+static void APIENTRY StubGetiv(GLuint, GLenum, GLint* v) { *v = 1; }
+static void APIENTRY StubInfoLog(GLuint, GLsizei, GLsizei*, GLchar* log) { log[0] = 0; }
+static GLint APIENTRY StubGetUniformLocation(GLuint, const GLchar* name) { return (GLint)name[0]; }
+static GLuint APIENTRY StubGetUniformBlockIndex(GLuint, const GLchar*) { return 0; }
+static void APIENTRY StubUniformBlockBinding(GLuint, GLuint, GLuint) {}
+static void APIENTRY StubUniform1i(GLint, GLint) {}
+static void APIENTRY StubUniform1f(GLint, GLfloat) {}
+static void APIENTRY StubUniform3fv(GLint, GLsizei, const GLfloat*) {}
+static void APIENTRY StubUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+
+static void InstallGLStubs() {
+    glad_glCreateShader = StubCreate;
+    glad_glCreateProgram = StubCreateProgram;
+    glad_glShaderSource = StubShaderSource;
+    glad_glCompileShader = StubUint;
+    glad_glLinkProgram = StubUint;
+    glad_glUseProgram = StubUint;
+    glad_glDeleteShader = StubUint;
+    glad_glAttachShader = StubUint2;
+    glad_glGetShaderiv = StubGetiv;
+    glad_glGetProgramiv = StubGetiv;
+    glad_glGetShaderInfoLog = StubInfoLog;
+    glad_glGetProgramInfoLog = StubInfoLog;
+    glad_glGetUniformLocation = StubGetUniformLocation;
+    glad_glGetUniformBlockIndex = StubGetUniformBlockIndex;
+    glad_glUniformBlockBinding = StubUniformBlockBinding;
+    glad_glUniform1i = StubUniform1i;
+    glad_glUniform1f = StubUniform1f;
+    glad_glUniform3fv = StubUniform3fv;
+    glad_glUniformMatrix4fv = StubUniformMatrix4fv;
+}
+
+// synthetic GLB: an n x n vertex grid with normals, uvs and u32 indices
+static std::vector<unsigned char> MakeGridGLB(int n) {
+    size_t verts = (size_t)n * n;
+    size_t quads = (size_t)(n - 1) * (n - 1);
+
+    std::vector<float> pos, nrm, uv;
+    std::vector<uint32_t> idx;
+    pos.reserve(verts * 3);
+    nrm.reserve(verts * 3);
+    uv.reserve(verts * 2);
+    idx.reserve(quads * 6);
+
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; x < n; x++) {
+            float u = (float)x / (n - 1), v = (float)y / (n - 1);
+            pos.insert(pos.end(), { u * 2.0f - 1.0f, 0.0f, v * 2.0f - 1.0f });
+            nrm.insert(nrm.end(), { 0.0f, 1.0f, 0.0f });
+            uv.insert(uv.end(), { u, v });
+        }
+    }
+
+    for (int y = 0; y + 1 < n; y++) {
+        for (int x = 0; x + 1 < n; x++) {
+            uint32_t i = (uint32_t)(y * n + x);
+            idx.insert(idx.end(), { i, i + n, i + 1, i + 1, i + n, i + n + 1 });
+        }
+    }
+
+    size_t posBytes = pos.size() * 4, nrmBytes = nrm.size() * 4;
+    size_t uvBytes = uv.size() * 4, idxBytes = idx.size() * 4;
+    size_t binBytes = posBytes + nrmBytes + uvBytes + idxBytes;
+
+    std::stringstream js;
+    js << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+       << "\"nodes\":[{\"mesh\":0}],"
+       << "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+       << "\"buffers\":[{\"byteLength\":" << binBytes << "}],"
+       << "\"bufferViews\":["
+       << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << posBytes << "},"
+       << "{\"buffer\":0,\"byteOffset\":" << posBytes << ",\"byteLength\":" << nrmBytes << "},"
+       << "{\"buffer\":0,\"byteOffset\":" << posBytes + nrmBytes << ",\"byteLength\":" << uvBytes << "},"
+       << "{\"buffer\":0,\"byteOffset\":" << posBytes + nrmBytes + uvBytes << ",\"byteLength\":" << idxBytes << "}],"
+       << "\"accessors\":["
+       << "{\"bufferView\":0,\"componentType\":5126,\"count\":" << verts << ",\"type\":\"VEC3\","
+       << "\"min\":[-1,0,-1],\"max\":[1,0,1]},"
+       << "{\"bufferView\":1,\"componentType\":5126,\"count\":" << verts << ",\"type\":\"VEC3\"},"
+       << "{\"bufferView\":2,\"componentType\":5126,\"count\":" << verts << ",\"type\":\"VEC2\"},"
+       << "{\"bufferView\":3,\"componentType\":5125,\"count\":" << idx.size() << ",\"type\":\"SCALAR\"}]}";
+
+    std::string json = js.str();
+    while (json.size() % 4) json += ' ';
+
+    std::vector<unsigned char> glb;
+    auto put32 = [&](uint32_t v) {
+        unsigned char b[4];
+        memcpy(b, &v, 4);
+        glb.insert(glb.end(), b, b + 4);
+    };
+    auto putBytes = [&](const void* p, size_t n) {
+        glb.insert(glb.end(), (const unsigned char*)p, (const unsigned char*)p + n);
+    };
+
+    put32(0x46546C67);    // "glTF"
+    put32(2);
+    put32((uint32_t)(12 + 8 + json.size() + 8 + binBytes));
+
+    put32((uint32_t)json.size());
+    put32(0x4E4F534A);    // JSON
+    putBytes(json.data(), json.size());
+
+    put32((uint32_t)binBytes);
+    put32(0x004E4942);    // BIN
+    putBytes(pos.data(), posBytes);
+    putBytes(nrm.data(), nrmBytes);
+    putBytes(uv.data(), uvBytes);
+    putBytes(idx.data(), idxBytes);
+
+    return glb;
+}
+
+// glTF model with count materials, each with its own size x size PNG
+// base color texture, still encoded as KeepEncodedImage leaves them
+static std::shared_ptr<tinygltf::Model> MakeTexturedModel(int count, int size) {
+    std::shared_ptr<tinygltf::Model> m = std::make_shared<tinygltf::Model>();
+    std::vector<unsigned char> pixels((size_t)size * size * 4);
+    uint32_t seed = 1;
+
+    for (int i = 0; i < count; i++) {
+        // gradients plus a little noise, compresses like a real texture
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                seed = seed * 1664525u + 1013904223u;
+                unsigned char* p = &pixels[((size_t)y * size + x) * 4];
+                p[0] = (unsigned char)(x + i * 16 + (seed >> 28));
+                p[1] = (unsigned char)(y + (seed >> 29));
+                p[2] = (unsigned char)((x ^ y) + i);
+                p[3] = 255;
+            }
+        }
+
+        tinygltf::Image img;
+        stbi_write_png_to_func([](void* ctx, void* data, int n) {
+            std::vector<unsigned char>* out = (std::vector<unsigned char>*)ctx;
+            out->insert(out->end(), (unsigned char*)data, (unsigned char*)data + n);
+        }, &img.image, size, size, 4, pixels.data(), size * 4);
+        img.width = img.height = -1;
+        m->images.push_back(img);
+
+        tinygltf::Texture t;
+        t.source = i;
+        m->textures.push_back(t);
+
+        tinygltf::Material mat;
+        mat.pbrMetallicRoughness.baseColorTexture.index = i;
+        m->materials.push_back(mat);
+    }
+    return m;
+}
+
+static void AddLoaderBenchmarks(BenchRunner& runner) {
+    const int sizes[] = { 32, 128, 512 };
+
+    for (int n : sizes) {
+        std::shared_ptr<std::vector<unsigned char>> glb =
+            std::make_shared<std::vector<unsigned char>>(MakeGridGLB(n));
+        double verts = (double)n * n;
+        std::string suffix = "/" + std::to_string(n * n) + "v";
+
+        // container parse + attribute decode, what loadModel does minus GL
+        runner.add("loader/decode_glb" + suffix, verts, [glb](size_t iters) {
+            for (size_t i = 0; i < iters; i++) {
+                Model::MeshData data;
+                Model::decodeGLB(glb->data(), glb->size(), data);
+                DoNotOptimize(data.vertices.data());
+            }
+        });
+
+        // attribute decode only, tinygltf parse done once up front
+        std::shared_ptr<tinygltf::Model> parsed = std::make_shared<tinygltf::Model>();
+        tinygltf::TinyGLTF loader;
+        std::string err, warn;
+        loader.LoadBinaryFromMemory(parsed.get(), &err, &warn, glb->data(), (unsigned int)glb->size());
+
+        runner.add("loader/decode_attributes" + suffix, verts, [parsed](size_t iters) {
+            Model::MeshData data;
+            for (size_t i = 0; i < iters; i++) {
+                Model::decode(*parsed, data);
+                DoNotOptimize(data.vertices.data());
+            }
+        });
+    }
+
+    // material textures, one thread against every core
+    std::shared_ptr<tinygltf::Model> textured = MakeTexturedModel(16, 512);
+    for (int threads : { 1, 0 }) {
+        std::string name = std::string("loader/decode_images_16x512") + (threads == 1 ? "_serial" : "_parallel");
+
+        runner.add(name, 16, [textured, threads](size_t iters) {
+            for (size_t i = 0; i < iters; i++) {
+                MaterialSet set;
+                for (int m = 0; m < (int)textured->materials.size(); m++) set.add(*textured, m);
+                set.decodeImages(*textured, threads);
+                DoNotOptimize(set.textures.back().rgba.data());
+            }
+        });
+    }
+}
+
+static void AddMathBenchmarks(BenchRunner& runner) {
+    runner.add("math/camera_view_projection", 1, [](size_t iters) {
+        Camera cam(1280, 720);
+        for (size_t i = 0; i < iters; i++) {
+            cam.position.x = (float)(i & 7) * 0.01f;
+            glm::mat4 vp = cam.getProjectionMatrix() * cam.getViewMatrix();
+            DoNotOptimize(vp);
+        }
+    });
+
+    runner.add("math/model_matrix", 1, [](size_t iters) {
+        float rot = 0.0f;
+        for (size_t i = 0; i < iters; i++) {
+            rot += 0.001f;
+            glm::mat4 m = Model::getModelMatrix(rot);
+            DoNotOptimize(m);
+        }
+    });
+}
+
+// CAD-like hierarchy: assemblies of fanout parts, depth levels deep
+static std::shared_ptr<SceneGraph> MakeSceneGraph(int fanout, int depth) {
+    std::shared_ptr<SceneGraph> g = std::make_shared<SceneGraph>();
+
+    std::vector<std::pair<int, int>> stack = { { -1, 0 } };    // parent, level
+    while (!stack.empty()) {
+        std::pair<int, int> top = stack.back();
+        stack.pop_back();
+
+        int i = g->count();
+        glm::vec3 t((float)(i % 7), (float)(i % 5) * 0.5f, 0.25f);
+        glm::quat r = glm::normalize(glm::quat(1.0f, 0.01f * (i % 3), 0.02f, 0.0f));
+        g->addNode(top.first, t, r, glm::vec3(1.0f), top.second == depth ? 0 : -1);
+
+        if (top.second < depth) {
+            for (int c = 0; c < fanout; c++) stack.push_back({ i, top.second + 1 });
+        }
+    }
+    g->update(1);
+    return g;
+}
+
+static void AddSceneBenchmarks(BenchRunner& runner) {
+    std::shared_ptr<SceneGraph> g = MakeSceneGraph(12, 4);     // 22621 nodes
+    std::shared_ptr<SceneGraph> big = MakeSceneGraph(8, 5);    // 37449 nodes
+
+    for (std::shared_ptr<SceneGraph> graph : { g, big }) {
+        std::string suffix = "_" + std::to_string(graph->count());
+        double nodes = graph->count();
+
+        runner.add("scene/update_all_1t" + suffix, nodes, [graph](size_t iters) {
+            for (size_t i = 0; i < iters; i++) {
+                graph->dirty[0] = 1;
+                graph->update(1);
+            }
+            DoNotOptimize(graph->world.back());
+        });
+
+        runner.add("scene/update_all_mt" + suffix, nodes, [graph](size_t iters) {
+            for (size_t i = 0; i < iters; i++) {
+                graph->dirty[0] = 1;
+                graph->update(0);
+            }
+            DoNotOptimize(graph->world.back());
+        });
+
+        // a handful of moving parts, the common case
+        runner.add("scene/update_64_parts" + suffix, 64, [graph](size_t iters) {
+            int n = graph->count();
+            for (size_t i = 0; i < iters; i++) {
+                for (int k = 0; k < 64; k++) graph->setTranslation((int)((k * 7919 + i) % n), glm::vec3((float)k));
+                graph->update(0);
+            }
+            DoNotOptimize(graph->world.back());
+        });
+
+        runner.add("scene/update_clean" + suffix, nodes, [graph](size_t iters) {
+            for (size_t i = 0; i < iters; i++) graph->update(0);
+            DoNotOptimize(graph->updatedNodes);
+        });
+    }
+}
+
+// humanoid-sized rig: 64 joints, each parented to one of the previous
+// few, every joint rotated by a 30 key linear channel
+static void MakeRig(Skeleton& sk, AnimationClip& clip) {
+    const int JOINTS = 64, KEYS = 30;
+
+    for (int j = 0; j < JOINTS; j++) {
+        sk.node.push_back(j);
+        sk.parent.push_back(j == 0 ? -1 : std::max(0, j - 1 - (j % 3)));
+        sk.restT.push_back(glm::vec3(0.0f, 0.1f, 0.0f));
+        sk.restR.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        sk.restS.push_back(glm::vec3(1.0f));
+        sk.jointSlot.push_back(j);
+        sk.inverseBind.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.1f * j, 0.0f)));
+    }
+
+    clip.duration = (KEYS - 1) / 30.0f;
+    for (int k = 0; k < KEYS; k++) clip.times.push_back(k / 30.0f);
+
+    for (int j = 0; j < JOINTS; j++) {
+        AnimationClip::Channel ch;
+        ch.slot = j;
+        ch.path = AnimationClip::ROTATION;
+        ch.interpolation = AnimationClip::LINEAR;
+        ch.keys = KEYS;
+        ch.timeOffset = 0;
+        ch.valueOffset = (int)clip.values.size();
+        for (int k = 0; k < KEYS; k++) {
+            float a = 0.02f * std::sin(k * 0.3f + j);
+            clip.values.insert(clip.values.end(), { std::sin(a), 0.0f, 0.0f, std::cos(a) });
+        }
+        clip.channels.push_back(ch);
+    }
+}
+
+static void AddAnimationBenchmarks(BenchRunner& runner) {
+    std::shared_ptr<Skeleton> sk = std::make_shared<Skeleton>();
+    std::shared_ptr<AnimationClip> clip = std::make_shared<AnimationClip>();
+    MakeRig(*sk, *clip);
+
+    for (int characters : { 1, 300 }) {
+        std::string suffix = "_" + std::to_string(characters) + "x64";
+
+        // sample + world matrices + palettes, what RenderScene does per frame
+        runner.add("anim/crowd" + suffix, characters, [sk, clip, characters](size_t iters) {
+            CrowdAnimator crowd;
+            crowd.resize(*sk, characters);
+            std::vector<float> times(characters), palettes((size_t)characters * sk->jointCount() * 12);
+
+            for (size_t i = 0; i < iters; i++) {
+                for (int c = 0; c < characters; c++) times[c] = i * 0.016f + c * 0.37f;
+                crowd.evaluate(*sk, *clip, times.data(), palettes.data());
+            }
+            DoNotOptimize(palettes.back());
+        });
+    }
+}
+
+// uv sphere, rings x segments quads, wound counter-clockwise from outside
+static void MakeSphere(int rings, int segments, std::vector<Model::Vertex>& vertices, std::vector<unsigned int>& indices) {
+    for (int i = 0; i <= rings; i++) {
+        for (int j = 0; j <= segments; j++) {
+            float theta = 3.14159265f * i / rings, phi = 6.2831853f * j / segments;
+            glm::vec3 p(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            vertices.push_back({ p, p, glm::vec2(0.0f), 0 });
+        }
+    }
+    for (int i = 0; i < rings; i++) {
+        for (int j = 0; j < segments; j++) {
+            unsigned int a = i * (segments + 1) + j, b = a + 1, c = a + segments + 1, d = c + 1;
+            indices.insert(indices.end(), { a, b, c, b, d, c });
+        }
+    }
+}
+
+static void AddMeshletBenchmarks(BenchRunner& runner) {
+    std::shared_ptr<std::vector<Model::Vertex>> vertices = std::make_shared<std::vector<Model::Vertex>>();
+    std::shared_ptr<std::vector<unsigned int>> indices = std::make_shared<std::vector<unsigned int>>();
+    MakeSphere(200, 400, *vertices, *indices);      // 160k triangles
+    double triangles = indices->size() / 3.0;
+
+    runner.add("meshlet/build_160k", triangles, [vertices, indices](size_t iters) {
+        MeshletSet set;
+        for (size_t i = 0; i < iters; i++) {
+            std::vector<unsigned int> copy = *indices;
+            set.build(*vertices, copy, { 0 });
+        }
+        DoNotOptimize(set.meshlets.size());
+    });
+
+    std::shared_ptr<MeshletSet> set = std::make_shared<MeshletSet>();
+    std::vector<unsigned int> clustered = *indices;
+    set->build(*vertices, clustered, { 0 });
+
+    // a field of spheres running away from the camera, most of them off screen
+    std::shared_ptr<std::vector<glm::mat4>> instances = std::make_shared<std::vector<glm::mat4>>();
+    for (int i = 0; i < 1024; i++) {
+        glm::vec3 at((i % 8 - 3.5f), 0.0f, -(i / 8) * 2.5f);
+        instances->push_back(glm::scale(glm::translate(glm::mat4(1.0f), at), glm::vec3(0.4f)));
+    }
+
+    Camera camera(1280, 720);
+    camera.position = glm::vec3(0.0f, 0.0f, 4.0f);
+    camera.target = glm::vec3(0.0f);
+    std::shared_ptr<std::vector<glm::vec4>> planes = std::make_shared<std::vector<glm::vec4>>(6);
+    camera.getFrustumPlanes(planes->data());
+    glm::vec3 eye = camera.position;
+
+    for (int threads : { 1, 0 }) {
+        std::string name = threads == 1 ? "meshlet/cull_1t_1024" : "meshlet/cull_mt_1024";
+        runner.add(name, 1024, [set, instances, planes, eye, threads](size_t iters) {
+            for (size_t i = 0; i < iters; i++) set->cull(instances->data(), (int)instances->size(), planes->data(), eye, threads);
+            DoNotOptimize(set->trianglesTested);
+        });
+    }
+}
+
+static void AddShaderBenchmarks(BenchRunner& runner) {
+    // constructed once on the stubbed GL, source files are read for real
+    std::shared_ptr<Shader> shader = std::make_shared<Shader>("shaders/skybox.vert", "shaders/skybox.frag");
+
+    runner.add("shader/setMat4", 1, [shader](size_t iters) {
+        glm::mat4 m(1.0f);
+        for (size_t i = 0; i < iters; i++) shader->setMat4("projection", m);
+    });
+
+    runner.add("shader/setVec3", 1, [shader](size_t iters) {
+        glm::vec3 v(1.0f);
+        for (size_t i = 0; i < iters; i++) shader->setVec3("lightPos", v);
+    });
+
+    runner.add("shader/setFloat", 1, [shader](size_t iters) {
+        for (size_t i = 0; i < iters; i++) shader->setFloat("ambientStrength", 0.4f);
+    });
+
+    // the per-frame skybox uniform block of the main loop
+    runner.add("shader/skybox_frame", 2, [shader](size_t iters) {
+        glm::mat4 view(1.0f), proj(1.0f);
+        for (size_t i = 0; i < iters; i++) {
+            shader->use();
+            shader->setMat4("view", view);
+            shader->setMat4("projection", proj);
+        }
+    });
+}
+
+static void AddLogBenchmarks(BenchRunner& runner) {
+    runner.add("log/GetCurrentTimeStamp", 1, [](size_t iters) {
+        for (size_t i = 0; i < iters; i++) {
+            std::string s = GetCurrentTimeStamp();
+            DoNotOptimize(s.data());
+        }
+    });
+
+    // file only, console echo would measure the terminal
+    runner.add("log/LogToFile", 1, [](size_t iters) {
+        for (size_t i = 0; i < iters; i++) LogToFile("INFO", "Recreated MSAA FBO with 4 samples");
+    });
+}
+
+static void AddConsoleBenchmarks(BenchRunner& runner) {
+    static const char* const lines[] = { "t_msaa 4", "help", "info", "t_msaa   8  extra", "not_a_command a b c" };
+    const size_t count = sizeof(lines) / sizeof(lines[0]);
+    const size_t known = sizeof(consoleCommands) / sizeof(consoleCommands[0]);
+
+    // parse plus the name dispatch ExecuteCommand does
+    runner.add("console/parse_dispatch", (double)count, [count, known](size_t iters) {
+        std::vector<std::string> input(lines, lines + count);
+        for (size_t i = 0; i < iters; i++) {
+            FrameArena::get().reset();
+            for (const std::string& line : input) {
+                ConsoleCommand c = ConsoleCommand::parse(line);
+                int hit = -1;
+                for (size_t k = 0; k < known; k++) {
+                    const char* n = consoleCommands[k];
+                    size_t len = strcspn(n, " ");
+                    if (c.name.size() == len && c.name.compare(0, len, n, len) == 0) hit = (int)k;
+                }
+                DoNotOptimize(hit);
+                DoNotOptimize(c.intArg(0, -1));
+            }
+        }
+    });
+}
+
+// the CPU side of one frame on the stubbed GL: moving scene graph
+// parts, a crowd, meshlet culling, uniforms, a console line and a log
+// line, all with the frame arena reset first like the main loop does
+struct HeadlessFrame {
+    std::shared_ptr<SceneGraph> graph = MakeSceneGraph(8, 4);
+    Skeleton skeleton;
+    AnimationClip clip;
+    CrowdAnimator crowd;
+    std::vector<float> times, palettes;
+    MeshletSet meshlets;
+    std::vector<glm::mat4> instances;
+    glm::vec4 planes[6];
+    glm::vec3 eye;
+    Shader shader = Shader("shaders/skybox.vert", "shaders/skybox.frag");
+    int frame = 0;
+
+    HeadlessFrame() {
+        MakeRig(skeleton, clip);
+        crowd.resize(skeleton, 64);
+        times.resize(64);
+        palettes.resize((size_t)64 * skeleton.jointCount() * 12);
+
+        std::vector<Model::Vertex> vertices;
+        std::vector<unsigned int> indices;
+        MakeSphere(50, 100, vertices, indices);
+        meshlets.build(vertices, indices, { 0 });
+        for (int i = 0; i < 256; i++) {
+            glm::vec3 at((i % 8 - 3.5f), 0.0f, -(i / 8) * 2.5f);
+            instances.push_back(glm::scale(glm::translate(glm::mat4(1.0f), at), glm::vec3(0.4f)));
+        }
+
+        Camera camera(1280, 720);
+        camera.position = glm::vec3(0.0f, 0.0f, 4.0f);
+        camera.target = glm::vec3(0.0f);
+        camera.getFrustumPlanes(planes);
+        eye = camera.position;
+    }
+
+    void run() {
+        FrameArena::get().reset();
+        PROFILE_SCOPE("frame");
+
+        for (int k = 0; k < 64; k++) graph->setTranslation((k * 7919 + frame) % graph->count(), glm::vec3((float)k));
+        graph->update(0);
+
+        for (int c = 0; c < 64; c++) times[c] = frame * 0.016f + c * 0.37f;
+        crowd.evaluate(skeleton, clip, times.data(), palettes.data());
+
+        meshlets.cull(instances.data(), (int)instances.size(), planes, eye);
+
+        glm::mat4 view(1.0f), proj(1.0f);
+        shader.use();
+        shader.setMat4("view", view);
+        shader.setMat4("projection", proj);
+
+        ConsoleCommand c = ConsoleCommand::parse("profile 8 frame_profile_of_a_long_name.json");
+        DoNotOptimize(c.intArg(0, 0));
+
+        LogInfof("frame %d, %zu triangles tested", frame, meshlets.trianglesTested);
+        Profiler::get().endFrame();
+        frame++;
+    }
+};
+
+static void AddFrameBenchmarks(BenchRunner& runner) {
+    std::shared_ptr<HeadlessFrame> f = std::make_shared<HeadlessFrame>();
+    runner.add("frame/headless_cpu", 1, [f](size_t iters) {
+        for (size_t i = 0; i < iters; i++) f->run();
+    });
+}
+
+// heap allocations of warmed-up headless frames, has to be zero
+static bool CheckFrameAllocations() {
+    const int WARMUP = 16, FRAMES = 256;
+
+    HeadlessFrame f;
+    for (int i = 0; i < WARMUP; i++) f.run();
+
+    unsigned long long before = AllocationCounter::now();
+    for (int i = 0; i < FRAMES; i++) f.run();
+    unsigned long long allocations = AllocationCounter::now() - before;
+
+    std::cout << "\nframe/allocations: " << allocations << " in " << FRAMES << " frames after "
+              << WARMUP << " warmup frames" << (allocations ? " -- FAILED, expected 0" : "") << "\n";
+    return allocations == 0;
+}
+
+int main(int argc, char** argv) {
+    BenchRunner runner;
+    std::string jsonPath, comparePath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue) runner.filter = argv[++i];
+        else if (arg == "--reps" && hasValue) runner.repetitions = std::max(1, atoi(argv[++i]));
+        else if (arg == "--warmup" && hasValue) runner.warmup = std::max(0, atoi(argv[++i]));
+        else if (arg == "--json" && hasValue) jsonPath = argv[++i];
+        else if (arg == "--compare" && hasValue) comparePath = argv[++i];
+        else {
+            std::cout << "usage: togl_bench [--filter substr] [--reps N] [--warmup N]"
+                         " [--json out.json] [--compare old.json]\n";
+            return 1;
+        }
+    }
+
+    InstallGLStubs();
+
+    logEcho = false;
+    logFile.open("togl_bench_log.txt", std::ios::out | std::ios::trunc);
+
+    AddLoaderBenchmarks(runner);
+    AddMathBenchmarks(runner);
+    AddSceneBenchmarks(runner);
+    AddAnimationBenchmarks(runner);
+    AddMeshletBenchmarks(runner);
+    AddShaderBenchmarks(runner);
+    AddLogBenchmarks(runner);
+    AddConsoleBenchmarks(runner);
+    AddFrameBenchmarks(runner);
+
+    runner.runAll();
+
+    bool allocationsOk = true;
+    if (std::string("frame/allocations").find(runner.filter) != std::string::npos) {
+        allocationsOk = CheckFrameAllocations();
+    }
+
+    if (!jsonPath.empty() && runner.writeJson(jsonPath)) {
+        std::cout << "\nresults written to " << jsonPath << "\n";
+    }
+    if (!comparePath.empty()) runner.compare(comparePath);
+
+    logFile.close();
+    return allocationsOk ? 0 : 1;
+}
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
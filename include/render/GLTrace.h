@@ -0,0 +1,1213 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+// GL command capture / replay.
+//
+// capture swaps glad's function pointers for recording wrappers, so every
+// call made through Shader, Model, MSAA_FBO and the main loop lands in a
+// compact binary trace together with buffer and texture contents.
+// GLTracePlayer re-issues the trace on another context with object names,
+// uniform locations and sync objects remapped.
+//
+// file: "TOGLTRC1", u32 version, u32 width, u32 height, then records of
+// u16 op, u32 payload size, payload. OP_SETUP_DONE separates resource
+// setup from the frames, OP_FRAME marks a swap.
+
+namespace gltrace {
+
+const uint32_t VERSION = 2;    // 2: glTexBuffer, op numbers after it moved
+
+// calls whose arguments are plain values or object names. one kind char
+// per argument:
+//   e value   b buffer   t texture   f framebuffer   r renderbuffer
+//   v vertex array   p program   s shader   l uniform location
+//   k uniform block index
+#define TOGL_TRACE_SIMPLE(X) \
+    X(ActiveTexture,                  "e")          \
+    X(AttachShader,                   "ps")         \
+    X(BindBuffer,                     "eb")         \
+    X(BindBufferBase,                 "eeb")        \
+    X(BindBufferRange,                "eebee")      \
+    X(BindFramebuffer,                "ef")         \
+    X(BindRenderbuffer,               "er")         \
+    X(BindTexture,                    "et")         \
+    X(BindVertexArray,                "v")          \
+    X(BlendFunc,                      "ee")         \
+    X(BlitFramebuffer,                "eeeeeeeeee") \
+    X(Clear,                          "e")          \
+    X(ClearColor,                     "eeee")       \
+    X(ClearDepth,                     "e")          \
+    X(ColorMask,                      "eeee")       \
+    X(CompileShader,                  "s")          \
+    X(CullFace,                       "e")          \
+    X(DeleteProgram,                  "p")          \
+    X(DeleteShader,                   "s")          \
+    X(DepthFunc,                      "e")          \
+    X(DepthMask,                      "e")          \
+    X(Disable,                        "e")          \
+    X(DisableVertexAttribArray,       "e")          \
+    X(DrawArrays,                     "eee")        \
+    X(DrawArraysInstanced,            "eeee")       \
+    X(DrawBuffer,                     "e")          \
+    X(DrawElements,                   "eeee")       \
+    X(DrawElementsInstanced,          "eeeee")      \
+    X(Enable,                         "e")          \
+    X(EnableVertexAttribArray,        "e")          \
+    X(FramebufferRenderbuffer,        "eeer")       \
+    X(FramebufferTexture2D,           "eeete")      \
+    X(GenerateMipmap,                 "e")          \
+    X(LinkProgram,                    "p")          \
+    X(ReadBuffer,                     "e")          \
+    X(RenderbufferStorage,            "eeee")       \
+    X(RenderbufferStorageMultisample, "eeeee")      \
+    X(Scissor,                        "eeee")       \
+    X(TexBuffer,                      "eeb")        \
+    X(TexParameteri,                  "eee")        \
+    X(Uniform1f,                      "le")         \
+    X(Uniform1i,                      "le")         \
+    X(Uniform2f,                      "lee")        \
+    X(Uniform3f,                      "leee")       \
+    X(Uniform4f,                      "leeee")      \
+    X(UniformBlockBinding,            "pke")        \
+    X(UseProgram,                     "p")          \
+    X(VertexAttribDivisor,            "ee")         \
+    X(VertexAttribIPointer,           "eeeee")      \
+    X(VertexAttribPointer,            "eeeeee")     \
+    X(Viewport,                       "eeee")
+
+enum Op : uint16_t {
+    OP_NONE = 0,
+    OP_FRAME,
+    OP_SETUP_DONE,
+#define TOGL_TRACE_ENUM(name, kinds) OP_##name,
+    TOGL_TRACE_SIMPLE(TOGL_TRACE_ENUM)
+#undef TOGL_TRACE_ENUM
+    OP_GenBuffers,
+    OP_GenFramebuffers,
+    OP_GenRenderbuffers,
+    OP_GenTextures,
+    OP_GenVertexArrays,
+    OP_DeleteBuffers,
+    OP_DeleteFramebuffers,
+    OP_DeleteRenderbuffers,
+    OP_DeleteTextures,
+    OP_DeleteVertexArrays,
+    OP_CreateShader,
+    OP_CreateProgram,
+    OP_ShaderSource,
+    OP_GetUniformLocation,
+    OP_GetUniformBlockIndex,
+    OP_Uniform1fv,
+    OP_Uniform3fv,
+    OP_Uniform4fv,
+    OP_UniformMatrix4fv,
+    OP_BufferData,
+    OP_BufferSubData,
+    OP_TexImage2D,
+    OP_TexSubImage2D,
+    OP_TexImage3D,
+    OP_TexSubImage3D,
+    OP_PixelStorei,
+    OP_FenceSync,
+    OP_ClientWaitSync,
+    OP_DeleteSync,
+    OP_MultiDrawElements,
+    OP_COUNT
+};
+
+inline const char* opName(int op) {
+    switch (op) {
+        case OP_FRAME: return "<frame>";
+        case OP_SETUP_DONE: return "<setup done>";
+#define TOGL_TRACE_NAME(name, kinds) case OP_##name: return "gl" #name;
+        TOGL_TRACE_SIMPLE(TOGL_TRACE_NAME)
+#undef TOGL_TRACE_NAME
+        case OP_GenBuffers: return "glGenBuffers";
+        case OP_GenFramebuffers: return "glGenFramebuffers";
+        case OP_GenRenderbuffers: return "glGenRenderbuffers";
+        case OP_GenTextures: return "glGenTextures";
+        case OP_GenVertexArrays: return "glGenVertexArrays";
+        case OP_DeleteBuffers: return "glDeleteBuffers";
+        case OP_DeleteFramebuffers: return "glDeleteFramebuffers";
+        case OP_DeleteRenderbuffers: return "glDeleteRenderbuffers";
+        case OP_DeleteTextures: return "glDeleteTextures";
+        case OP_DeleteVertexArrays: return "glDeleteVertexArrays";
+        case OP_CreateShader: return "glCreateShader";
+        case OP_CreateProgram: return "glCreateProgram";
+        case OP_ShaderSource: return "glShaderSource";
+        case OP_GetUniformLocation: return "glGetUniformLocation";
+        case OP_GetUniformBlockIndex: return "glGetUniformBlockIndex";
+        case OP_Uniform1fv: return "glUniform1fv";
+        case OP_Uniform3fv: return "glUniform3fv";
+        case OP_Uniform4fv: return "glUniform4fv";
+        case OP_UniformMatrix4fv: return "glUniformMatrix4fv";
+        case OP_BufferData: return "glBufferData";
+        case OP_BufferSubData: return "glBufferSubData";
+        case OP_TexImage2D: return "glTexImage2D";
+        case OP_TexSubImage2D: return "glTexSubImage2D";
+        case OP_TexImage3D: return "glTexImage3D";
+        case OP_TexSubImage3D: return "glTexSubImage3D";
+        case OP_PixelStorei: return "glPixelStorei";
+        case OP_FenceSync: return "glFenceSync";
+        case OP_ClientWaitSync: return "glClientWaitSync";
+        case OP_DeleteSync: return "glDeleteSync";
+        case OP_MultiDrawElements: return "glMultiDrawElements";
+    }
+    return "<unknown>";
+}
+
+// bytes of a client-side image upload, honouring GL_UNPACK_ALIGNMENT
+inline size_t imageBytes(GLenum format, GLenum type, int w, int h, int d, int align) {
+    size_t pixel = 4;
+
+    switch (type) {
+        case GL_UNSIGNED_INT_24_8:
+        case GL_UNSIGNED_INT_8_8_8_8:
+        case GL_UNSIGNED_INT_8_8_8_8_REV:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+            pixel = 4;
+            break;
+        default: {
+            size_t comp = 1;
+            if (type == GL_UNSIGNED_SHORT || type == GL_SHORT || type == GL_HALF_FLOAT) comp = 2;
+            if (type == GL_UNSIGNED_INT || type == GL_INT || type == GL_FLOAT) comp = 4;
+
+            size_t n = 4;
+            if (format == GL_RED || format == GL_DEPTH_COMPONENT || format == GL_RED_INTEGER) n = 1;
+            if (format == GL_RG) n = 2;
+            if (format == GL_RGB || format == GL_BGR) n = 3;
+            pixel = comp * n;
+        }
+    }
+
+    size_t row = pixel * (size_t)w;
+    size_t stride = (row + align - 1) / align * align;
+    if (w <= 0 || h <= 0 || d <= 0) return 0;
+    return (stride * (h - 1) + row) * d;
+}
+
+// raw little-endian encoding
+class Writer {
+public:
+    std::vector<unsigned char> data;
+
+    template <typename T>
+    void put(const T& v) {
+        const unsigned char* p = (const unsigned char*)&v;
+        data.insert(data.end(), p, p + sizeof(T));
+    }
+
+    // pointers passed to GL by value are buffer offsets
+    template <typename T>
+    void arg(T v) {
+        if constexpr (std::is_pointer_v<T>) put<uint64_t>((uint64_t)(uintptr_t)v);
+        else put<T>(v);
+    }
+
+    void bytes(const void* p, size_t n) {
+        put<uint64_t>(p ? n : 0);
+        if (p && n) data.insert(data.end(), (const unsigned char*)p, (const unsigned char*)p + n);
+    }
+
+    void str(const char* s, size_t n) {
+        put<uint32_t>((uint32_t)n);
+        data.insert(data.end(), s, s + n);
+    }
+
+    void begin(uint16_t op) {
+        put<uint16_t>(op);
+        recordStart = data.size();
+        put<uint32_t>(0);
+    }
+
+    void end() {
+        uint32_t len = (uint32_t)(data.size() - recordStart - sizeof(uint32_t));
+        memcpy(&data[recordStart], &len, sizeof(len));
+    }
+
+private:
+    size_t recordStart = 0;
+};
+
+class Reader {
+public:
+    const unsigned char* p = nullptr;
+
+    template <typename T>
+    T get() {
+        T v;
+        memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    template <typename T>
+    T arg() {
+        if constexpr (std::is_pointer_v<T>) return (T)(uintptr_t)get<uint64_t>();
+        else return get<T>();
+    }
+
+    // returns nullptr for "no data"
+    const void* bytes(size_t* n = nullptr) {
+        uint64_t len = get<uint64_t>();
+        const void* out = len ? p : nullptr;
+        p += len;
+        if (n) *n = (size_t)len;
+        return out;
+    }
+
+    std::string str() {
+        uint32_t n = get<uint32_t>();
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+};
+
+} // namespace gltrace
+
+class GLTraceCapture {
+public:
+    static GLTraceCapture& get() {
+        static GLTraceCapture c;
+        return c;
+    }
+
+    gltrace::Writer out;
+    bool recording = false;
+
+    bool active() const { return installed; }
+
+    // hook glad and record until `frames` swaps have been seen
+    void start(const std::string& path, int frames, int width, int height) {
+        if (installed) return;
+
+        filename = path;
+        framesLeft = frames > 0 ? frames : 1;
+        framesDone = 0;
+
+        out.data.clear();
+        out.data.insert(out.data.end(), MAGIC, MAGIC + 8);
+        out.put<uint32_t>(gltrace::VERSION);
+        out.put<uint32_t>((uint32_t)width);
+        out.put<uint32_t>((uint32_t)height);
+
+        install(true);
+        installed = true;
+        recording = true;
+
+        std::cout << "GL trace: capturing " << framesLeft << " frame(s) to " << filename << "\n";
+    }
+
+    // call once resources are loaded, before the first frame
+    void setupDone() {
+        if (!installed) return;
+
+        out.begin(gltrace::OP_SETUP_DONE);
+        out.end();
+    }
+
+    // ImGui and other foreign GL users are kept out of the trace
+    void pause()  { if (installed) recording = false; }
+    void resume() { if (installed) recording = true; }
+
+    // call right before SwapBuffers
+    void frame() {
+        if (!installed) return;
+
+        out.begin(gltrace::OP_FRAME);
+        out.end();
+        framesDone++;
+
+        if (--framesLeft == 0) finish();
+    }
+
+    void finish() {
+        if (!installed) return;
+
+        install(false);
+        installed = false;
+        recording = false;
+
+        std::ofstream f(filename, std::ios::binary);
+        if (!f.is_open()) {
+            std::cerr << "GL trace: cannot open " << filename << std::endl;
+            return;
+        }
+        f.write((const char*)out.data.data(), out.data.size());
+
+        std::cout << "GL trace: " << framesDone << " frame(s), "
+                  << (out.data.size() >> 10) << " KB written to " << filename << "\n";
+
+        out.data.clear();
+        out.data.shrink_to_fit();
+    }
+
+    static constexpr const char* MAGIC = "TOGLTRC1";
+
+    // unpack alignment seen so far, needed to size texture uploads
+    int unpackAlignment = 4;
+
+    struct Mapping {
+        GLenum target = 0;
+        GLintptr offset = 0;
+        GLsizeiptr length = 0;
+        GLbitfield access = 0;
+        unsigned char* ptr = nullptr;
+    };
+    std::vector<Mapping> mappings;
+
+private:
+    std::string filename;
+    int framesLeft = 0;
+    int framesDone = 0;
+    bool installed = false;
+
+    void install(bool on);
+};
+
+namespace gltrace {
+
+// generic wrapper for TOGL_TRACE_SIMPLE calls
+template <int OP, typename P> struct Hook;
+
+template <int OP, typename R, typename... A>
+struct Hook<OP, R (APIENTRYP)(A...)> {
+    static inline R (APIENTRYP real)(A...) = nullptr;
+
+    static R APIENTRY call(A... a) {
+        GLTraceCapture& c = GLTraceCapture::get();
+        if (c.recording) {
+            c.out.begin(OP);
+            (c.out.arg(a), ...);
+            c.out.end();
+        }
+        return real(a...);
+    }
+};
+
+typedef void (APIENTRYP GenFn)(GLsizei, GLuint*);
+typedef void (APIENTRYP DeleteFn)(GLsizei, const GLuint*);
+
+template <int OP>
+struct GenHook {
+    static inline GenFn real = nullptr;
+
+    static void APIENTRY call(GLsizei n, GLuint* names) {
+        real(n, names);
+
+        GLTraceCapture& c = GLTraceCapture::get();
+        if (c.recording) {
+            c.out.begin(OP);
+            c.out.put<int32_t>(n);
+            for (GLsizei i = 0; i < n; i++) c.out.put<uint32_t>(names[i]);
+            c.out.end();
+        }
+    }
+};
+
+template <int OP>
+struct DeleteHook {
+    static inline DeleteFn real = nullptr;
+
+    static void APIENTRY call(GLsizei n, const GLuint* names) {
+        GLTraceCapture& c = GLTraceCapture::get();
+        if (c.recording) {
+            c.out.begin(OP);
+            c.out.put<int32_t>(n);
+            for (GLsizei i = 0; i < n; i++) c.out.put<uint32_t>(names[i]);
+            c.out.end();
+        }
+
+        real(n, names);
+    }
+};
+
+template <int OP, int N>
+struct UniformvHook {
+    static inline PFNGLUNIFORM3FVPROC real = nullptr;
+
+    static void APIENTRY call(GLint loc, GLsizei count, const GLfloat* v) {
+        GLTraceCapture& c = GLTraceCapture::get();
+        if (c.recording) {
+            c.out.begin(OP);
+            c.out.put<int32_t>(loc);
+            c.out.put<int32_t>(count);
+            c.out.bytes(v, sizeof(GLfloat) * N * count);
+            c.out.end();
+        }
+        real(loc, count, v);
+    }
+};
+
+// calls with pointers to client memory, return values or side state
+struct Special {
+    static inline decltype(glad_glCreateShader) CreateShader = nullptr;
+    static inline decltype(glad_glCreateProgram) CreateProgram = nullptr;
+    static inline decltype(glad_glShaderSource) ShaderSource = nullptr;
+    static inline decltype(glad_glGetUniformLocation) GetUniformLocation = nullptr;
+    static inline decltype(glad_glGetUniformBlockIndex) GetUniformBlockIndex = nullptr;
+    static inline decltype(glad_glUniformMatrix4fv) UniformMatrix4fv = nullptr;
+    static inline decltype(glad_glBufferData) BufferData = nullptr;
+    static inline decltype(glad_glBufferSubData) BufferSubData = nullptr;
+    static inline decltype(glad_glTexImage2D) TexImage2D = nullptr;
+    static inline decltype(glad_glTexSubImage2D) TexSubImage2D = nullptr;
+    static inline decltype(glad_glTexImage3D) TexImage3D = nullptr;
+    static inline decltype(glad_glTexSubImage3D) TexSubImage3D = nullptr;
+    static inline decltype(glad_glPixelStorei) PixelStorei = nullptr;
+    static inline decltype(glad_glMapBufferRange) MapBufferRange = nullptr;
+    static inline decltype(glad_glFlushMappedBufferRange) FlushMappedBufferRange = nullptr;
+    static inline decltype(glad_glUnmapBuffer) UnmapBuffer = nullptr;
+    static inline decltype(glad_glFenceSync) FenceSync = nullptr;
+    static inline decltype(glad_glClientWaitSync) ClientWaitSync = nullptr;
+    static inline decltype(glad_glDeleteSync) DeleteSync = nullptr;
+    static inline decltype(glad_glMultiDrawElements) MultiDrawElements = nullptr;
+
+    static Writer& rec() { return GLTraceCapture::get().out; }
+    static bool on() { return GLTraceCapture::get().recording; }
+
+    static GLuint APIENTRY createShader(GLenum type) {
+        GLuint s = CreateShader(type);
+        if (on()) {
+            rec().begin(OP_CreateShader);
+            rec().put<uint32_t>(type);
+            rec().put<uint32_t>(s);
+            rec().end();
+        }
+        return s;
+    }
+
+    static GLuint APIENTRY createProgram() {
+        GLuint p = CreateProgram();
+        if (on()) {
+            rec().begin(OP_CreateProgram);
+            rec().put<uint32_t>(p);
+            rec().end();
+        }
+        return p;
+    }
+
+    static void APIENTRY shaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths) {
+        if (on()) {
+            rec().begin(OP_ShaderSource);
+            rec().put<uint32_t>(shader);
+            rec().put<int32_t>(count);
+            for (GLsizei i = 0; i < count; i++) {
+                size_t n = (lengths && lengths[i] >= 0) ? (size_t)lengths[i] : strlen(strings[i]);
+                rec().str(strings[i], n);
+            }
+            rec().end();
+        }
+        ShaderSource(shader, count, strings, lengths);
+    }
+
+    static GLint APIENTRY getUniformLocation(GLuint program, const GLchar* name) {
+        GLint loc = GetUniformLocation(program, name);
+        if (on()) {
+            rec().begin(OP_GetUniformLocation);
+            rec().put<uint32_t>(program);
+            rec().str(name, strlen(name));
+            rec().put<int32_t>(loc);
+            rec().end();
+        }
+        return loc;
+    }
+
+    static GLuint APIENTRY getUniformBlockIndex(GLuint program, const GLchar* name) {
+        GLuint index = GetUniformBlockIndex(program, name);
+        if (on()) {
+            rec().begin(OP_GetUniformBlockIndex);
+            rec().put<uint32_t>(program);
+            rec().str(name, strlen(name));
+            rec().put<uint32_t>(index);
+            rec().end();
+        }
+        return index;
+    }
+
+    static void APIENTRY uniformMatrix4fv(GLint loc, GLsizei count, GLboolean transpose, const GLfloat* v) {
+        if (on()) {
+            rec().begin(OP_UniformMatrix4fv);
+            rec().put<int32_t>(loc);
+            rec().put<int32_t>(count);
+            rec().put<uint8_t>(transpose);
+            rec().bytes(v, sizeof(GLfloat) * 16 * count);
+            rec().end();
+        }
+        UniformMatrix4fv(loc, count, transpose, v);
+    }
+
+    static void APIENTRY bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+        if (on()) {
+            rec().begin(OP_BufferData);
+            rec().put<uint32_t>(target);
+            rec().put<int64_t>(size);
+            rec().bytes(data, size);
+            rec().put<uint32_t>(usage);
+            rec().end();
+        }
+        BufferData(target, size, data, usage);
+    }
+
+    static void recordSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+        rec().begin(OP_BufferSubData);
+        rec().put<uint32_t>(target);
+        rec().put<int64_t>(offset);
+        rec().put<int64_t>(size);
+        rec().bytes(data, size);
+        rec().end();
+    }
+
+    static void APIENTRY bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+        if (on()) recordSubData(target, offset, size, data);
+        BufferSubData(target, offset, size, data);
+    }
+
+    static size_t unpackBytes(GLenum format, GLenum type, int w, int h, int d) {
+        return imageBytes(format, type, w, h, d, GLTraceCapture::get().unpackAlignment);
+    }
+
+    static void APIENTRY texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei w, GLsizei h,
+                                    GLint border, GLenum format, GLenum type, const void* pixels) {
+        if (on()) {
+            rec().begin(OP_TexImage2D);
+            rec().put<uint32_t>(target);
+            rec().put<int32_t>(level);
+            rec().put<int32_t>(internalformat);
+            rec().put<int32_t>(w);
+            rec().put<int32_t>(h);
+            rec().put<int32_t>(border);
+            rec().put<uint32_t>(format);
+            rec().put<uint32_t>(type);
+            rec().bytes(pixels, unpackBytes(format, type, w, h, 1));
+            rec().end();
+        }
+        TexImage2D(target, level, internalformat, w, h, border, format, type, pixels);
+    }
+
+    static void APIENTRY texSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei w, GLsizei h,
+                                       GLenum format, GLenum type, const void* pixels) {
+        if (on()) {
+            rec().begin(OP_TexSubImage2D);
+            rec().put<uint32_t>(target);
+            rec().put<int32_t>(level);
+            rec().put<int32_t>(x);
+            rec().put<int32_t>(y);
+            rec().put<int32_t>(w);
+            rec().put<int32_t>(h);
+            rec().put<uint32_t>(format);
+            rec().put<uint32_t>(type);
+            rec().bytes(pixels, unpackBytes(format, type, w, h, 1));
+            rec().end();
+        }
+        TexSubImage2D(target, level, x, y, w, h, format, type, pixels);
+    }
+
+    static void APIENTRY texImage3D(GLenum target, GLint level, GLint internalformat, GLsizei w, GLsizei h,
+                                    GLsizei d, GLint border, GLenum format, GLenum type, const void* pixels) {
+        if (on()) {
+            rec().begin(OP_TexImage3D);
+            rec().put<uint32_t>(target);
+            rec().put<int32_t>(level);
+            rec().put<int32_t>(internalformat);
+            rec().put<int32_t>(w);
+            rec().put<int32_t>(h);
+            rec().put<int32_t>(d);
+            rec().put<int32_t>(border);
+            rec().put<uint32_t>(format);
+            rec().put<uint32_t>(type);
+            rec().bytes(pixels, unpackBytes(format, type, w, h, d));
+            rec().end();
+        }
+        TexImage3D(target, level, internalformat, w, h, d, border, format, type, pixels);
+    }
+
+    static void APIENTRY texSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z,
+                                       GLsizei w, GLsizei h, GLsizei d, GLenum format, GLenum type,
+                                       const void* pixels) {
+        if (on()) {
+            rec().begin(OP_TexSubImage3D);
+            rec().put<uint32_t>(target);
+            rec().put<int32_t>(level);
+            rec().put<int32_t>(x);
+            rec().put<int32_t>(y);
+            rec().put<int32_t>(z);
+            rec().put<int32_t>(w);
+            rec().put<int32_t>(h);
+            rec().put<int32_t>(d);
+            rec().put<uint32_t>(format);
+            rec().put<uint32_t>(type);
+            rec().bytes(pixels, unpackBytes(format, type, w, h, d));
+            rec().end();
+        }
+        TexSubImage3D(target, level, x, y, z, w, h, d, format, type, pixels);
+    }
+
+    static void APIENTRY pixelStorei(GLenum pname, GLint param) {
+        if (pname == GL_UNPACK_ALIGNMENT) GLTraceCapture::get().unpackAlignment = param;
+        if (on()) {
+            rec().begin(OP_PixelStorei);
+            rec().put<uint32_t>(pname);
+            rec().put<int32_t>(param);
+            rec().end();
+        }
+        PixelStorei(pname, param);
+    }
+
+    // mapped writes are turned into BufferSubData records on flush/unmap
+    static void* APIENTRY mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        void* p = MapBufferRange(target, offset, length, access);
+        if (p) {
+            GLTraceCapture::Mapping m;
+            m.target = target;
+            m.offset = offset;
+            m.length = length;
+            m.access = access;
+            m.ptr = (unsigned char*)p;
+            GLTraceCapture::get().mappings.push_back(m);
+        }
+        return p;
+    }
+
+    static GLTraceCapture::Mapping* findMapping(GLenum target) {
+        std::vector<GLTraceCapture::Mapping>& maps = GLTraceCapture::get().mappings;
+        for (size_t i = maps.size(); i-- > 0;) {
+            if (maps[i].target == target) return &maps[i];
+        }
+        return nullptr;
+    }
+
+    static void APIENTRY flushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length) {
+        GLTraceCapture::Mapping* m = findMapping(target);
+        if (on() && m) recordSubData(target, m->offset + offset, length, m->ptr + offset);
+        FlushMappedBufferRange(target, offset, length);
+    }
+
+    static GLboolean APIENTRY unmapBuffer(GLenum target) {
+        GLTraceCapture::Mapping* m = findMapping(target);
+        if (m) {
+            bool explicitFlush = (m->access & GL_MAP_FLUSH_EXPLICIT_BIT) != 0;
+            if (on() && (m->access & GL_MAP_WRITE_BIT) && !explicitFlush) {
+                recordSubData(target, m->offset, m->length, m->ptr);
+            }
+            std::vector<GLTraceCapture::Mapping>& maps = GLTraceCapture::get().mappings;
+            maps.erase(maps.begin() + (m - maps.data()));
+        }
+        return UnmapBuffer(target);
+    }
+
+    static GLsync APIENTRY fenceSync(GLenum condition, GLbitfield flags) {
+        GLsync s = FenceSync(condition, flags);
+        if (on()) {
+            rec().begin(OP_FenceSync);
+            rec().put<uint32_t>(condition);
+            rec().put<uint32_t>(flags);
+            rec().arg(s);
+            rec().end();
+        }
+        return s;
+    }
+
+    static GLenum APIENTRY clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+        if (on()) {
+            rec().begin(OP_ClientWaitSync);
+            rec().arg(sync);
+            rec().put<uint32_t>(flags);
+            rec().put<uint64_t>(timeout);
+            rec().end();
+        }
+        return ClientWaitSync(sync, flags, timeout);
+    }
+
+    static void APIENTRY deleteSync(GLsync sync) {
+        if (on()) {
+            rec().begin(OP_DeleteSync);
+            rec().arg(sync);
+            rec().end();
+        }
+        DeleteSync(sync);
+    }
+
+    // counts and offsets (into the bound element buffer) of every draw
+    static void APIENTRY multiDrawElements(GLenum mode, const GLsizei* counts, GLenum type,
+                                           const void* const* offsets, GLsizei drawcount) {
+        if (on()) {
+            rec().begin(OP_MultiDrawElements);
+            rec().put<uint32_t>(mode);
+            rec().put<uint32_t>(type);
+            rec().put<int32_t>(drawcount);
+            for (GLsizei i = 0; i < drawcount; i++) {
+                rec().put<int32_t>(counts[i]);
+                rec().put<uint64_t>((uint64_t)(uintptr_t)offsets[i]);
+            }
+            rec().end();
+        }
+        MultiDrawElements(mode, counts, type, offsets, drawcount);
+    }
+};
+
+// swap a glad slot for a hook (on) or put the real function back (off)
+template <typename P>
+inline void swapHook(bool on, P& slot, P& real, P hook) {
+    if (on) {
+        if (!slot) return;
+        real = slot;
+        slot = hook;
+    } else if (real) {
+        slot = real;
+        real = nullptr;
+    }
+}
+
+} // namespace gltrace
+
+inline void GLTraceCapture::install(bool on) {
+    using namespace gltrace;
+
+#define TOGL_TRACE_INSTALL(name, kinds) \
+    swapHook(on, glad_gl##name, Hook<OP_##name, decltype(glad_gl##name)>::real, \
+             &Hook<OP_##name, decltype(glad_gl##name)>::call);
+    TOGL_TRACE_SIMPLE(TOGL_TRACE_INSTALL)
+#undef TOGL_TRACE_INSTALL
+
+    swapHook<GenFn>(on, glad_glGenBuffers, GenHook<OP_GenBuffers>::real, &GenHook<OP_GenBuffers>::call);
+    swapHook<GenFn>(on, glad_glGenFramebuffers, GenHook<OP_GenFramebuffers>::real, &GenHook<OP_GenFramebuffers>::call);
+    swapHook<GenFn>(on, glad_glGenRenderbuffers, GenHook<OP_GenRenderbuffers>::real, &GenHook<OP_GenRenderbuffers>::call);
+    swapHook<GenFn>(on, glad_glGenTextures, GenHook<OP_GenTextures>::real, &GenHook<OP_GenTextures>::call);
+    swapHook<GenFn>(on, glad_glGenVertexArrays, GenHook<OP_GenVertexArrays>::real, &GenHook<OP_GenVertexArrays>::call);
+
+    swapHook<DeleteFn>(on, glad_glDeleteBuffers, DeleteHook<OP_DeleteBuffers>::real, &DeleteHook<OP_DeleteBuffers>::call);
+    swapHook<DeleteFn>(on, glad_glDeleteFramebuffers, DeleteHook<OP_DeleteFramebuffers>::real, &DeleteHook<OP_DeleteFramebuffers>::call);
+    swapHook<DeleteFn>(on, glad_glDeleteRenderbuffers, DeleteHook<OP_DeleteRenderbuffers>::real, &DeleteHook<OP_DeleteRenderbuffers>::call);
+    swapHook<DeleteFn>(on, glad_glDeleteTextures, DeleteHook<OP_DeleteTextures>::real, &DeleteHook<OP_DeleteTextures>::call);
+    swapHook<DeleteFn>(on, glad_glDeleteVertexArrays, DeleteHook<OP_DeleteVertexArrays>::real, &DeleteHook<OP_DeleteVertexArrays>::call);
+
+    swapHook(on, glad_glUniform1fv, UniformvHook<OP_Uniform1fv, 1>::real, &UniformvHook<OP_Uniform1fv, 1>::call);
+    swapHook(on, glad_glUniform3fv, UniformvHook<OP_Uniform3fv, 3>::real, &UniformvHook<OP_Uniform3fv, 3>::call);
+    swapHook(on, glad_glUniform4fv, UniformvHook<OP_Uniform4fv, 4>::real, &UniformvHook<OP_Uniform4fv, 4>::call);
+
+    swapHook(on, glad_glCreateShader, Special::CreateShader, &Special::createShader);
+    swapHook(on, glad_glCreateProgram, Special::CreateProgram, &Special::createProgram);
+    swapHook(on, glad_glShaderSource, Special::ShaderSource, &Special::shaderSource);
+    swapHook(on, glad_glGetUniformLocation, Special::GetUniformLocation, &Special::getUniformLocation);
+    swapHook(on, glad_glGetUniformBlockIndex, Special::GetUniformBlockIndex, &Special::getUniformBlockIndex);
+    swapHook(on, glad_glUniformMatrix4fv, Special::UniformMatrix4fv, &Special::uniformMatrix4fv);
+    swapHook(on, glad_glBufferData, Special::BufferData, &Special::bufferData);
+    swapHook(on, glad_glBufferSubData, Special::BufferSubData, &Special::bufferSubData);
+    swapHook(on, glad_glTexImage2D, Special::TexImage2D, &Special::texImage2D);
+    swapHook(on, glad_glTexSubImage2D, Special::TexSubImage2D, &Special::texSubImage2D);
+    swapHook(on, glad_glTexImage3D, Special::TexImage3D, &Special::texImage3D);
+    swapHook(on, glad_glTexSubImage3D, Special::TexSubImage3D, &Special::texSubImage3D);
+    swapHook(on, glad_glPixelStorei, Special::PixelStorei, &Special::pixelStorei);
+    swapHook(on, glad_glMapBufferRange, Special::MapBufferRange, &Special::mapBufferRange);
+    swapHook(on, glad_glFlushMappedBufferRange, Special::FlushMappedBufferRange, &Special::flushMappedBufferRange);
+    swapHook(on, glad_glUnmapBuffer, Special::UnmapBuffer, &Special::unmapBuffer);
+    swapHook(on, glad_glFenceSync, Special::FenceSync, &Special::fenceSync);
+    swapHook(on, glad_glClientWaitSync, Special::ClientWaitSync, &Special::clientWaitSync);
+    swapHook(on, glad_glDeleteSync, Special::DeleteSync, &Special::deleteSync);
+    swapHook(on, glad_glMultiDrawElements, Special::MultiDrawElements, &Special::multiDrawElements);
+
+    if (!on) mappings.clear();
+}
+
+// re-issues a trace. object names from the capture are translated to the
+// names generated here; framebuffer 0 is redirected to `defaultFramebuffer`
+// so the trace can run on a surfaceless context.
+class GLTracePlayer {
+public:
+    struct Record {
+        uint16_t op;
+        uint32_t size;
+        const unsigned char* payload;
+    };
+
+    int width = 0, height = 0;
+    std::vector<Record> setup;                 // everything before OP_SETUP_DONE
+    std::vector<std::vector<Record>> frames;   // one list per captured frame
+
+    GLuint defaultFramebuffer = 0;
+
+    bool load(const std::string& path) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f.is_open()) {
+            std::cerr << "GL trace: cannot open " << path << std::endl;
+            return false;
+        }
+
+        file.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        if (file.size() < 20 || memcmp(file.data(), GLTraceCapture::MAGIC, 8) != 0) {
+            std::cerr << "GL trace: bad header in " << path << std::endl;
+            return false;
+        }
+
+        gltrace::Reader r;
+        r.p = file.data() + 8;
+        uint32_t version = r.get<uint32_t>();
+        if (version != gltrace::VERSION) {
+            std::cerr << "GL trace: unsupported version " << version << std::endl;
+            return false;
+        }
+        width = (int)r.get<uint32_t>();
+        height = (int)r.get<uint32_t>();
+
+        const unsigned char* end = file.data() + file.size();
+        std::vector<Record>* cur = &setup;
+        frames.emplace_back();
+
+        while (r.p + 6 <= end) {
+            Record rec;
+            rec.op = r.get<uint16_t>();
+            rec.size = r.get<uint32_t>();
+            rec.payload = r.p;
+            if (r.p + rec.size > end) {
+                std::cerr << "GL trace: truncated record" << std::endl;
+                return false;
+            }
+            r.p += rec.size;
+
+            if (rec.op == gltrace::OP_SETUP_DONE) {
+                cur = &frames.back();
+                continue;
+            }
+
+            cur->push_back(rec);
+            if (rec.op == gltrace::OP_FRAME) {
+                if (cur == &setup) {
+                    // no setup marker, the first frame doubles as setup
+                    cur = &frames.back();
+                    continue;
+                }
+                frames.emplace_back();
+                cur = &frames.back();
+            }
+        }
+
+        // anything after the last swap was never presented
+        if (!frames.empty() && (frames.back().empty() || frames.back().back().op != gltrace::OP_FRAME)) {
+            frames.pop_back();
+        }
+        return true;
+    }
+
+    void execute(const Record& rec) {
+        using namespace gltrace;
+
+        Reader r;
+        r.p = rec.payload;
+
+        switch (rec.op) {
+            case OP_FRAME:
+            case OP_SETUP_DONE:
+                return;
+
+#define TOGL_TRACE_PLAY(name, kinds) \
+            case OP_##name: \
+                playSimple(glad_gl##name, kinds, r); \
+                if (rec.op == OP_UseProgram) currentProgram = firstProgram; \
+                return;
+            TOGL_TRACE_SIMPLE(TOGL_TRACE_PLAY)
+#undef TOGL_TRACE_PLAY
+
+            case OP_GenBuffers:          gen(r, glGenBuffers, buffers); return;
+            case OP_GenFramebuffers:     gen(r, glGenFramebuffers, framebuffers); return;
+            case OP_GenRenderbuffers:    gen(r, glGenRenderbuffers, renderbuffers); return;
+            case OP_GenTextures:         gen(r, glGenTextures, textures); return;
+            case OP_GenVertexArrays:     gen(r, glGenVertexArrays, vertexArrays); return;
+            case OP_DeleteBuffers:       del(r, glDeleteBuffers, buffers); return;
+            case OP_DeleteFramebuffers:  del(r, glDeleteFramebuffers, framebuffers); return;
+            case OP_DeleteRenderbuffers: del(r, glDeleteRenderbuffers, renderbuffers); return;
+            case OP_DeleteTextures:      del(r, glDeleteTextures, textures); return;
+            case OP_DeleteVertexArrays:  del(r, glDeleteVertexArrays, vertexArrays); return;
+
+            case OP_CreateShader: {
+                GLenum type = r.get<uint32_t>();
+                GLuint old = r.get<uint32_t>();
+                shaders[old] = glCreateShader(type);
+                return;
+            }
+            case OP_CreateProgram: {
+                GLuint old = r.get<uint32_t>();
+                programs[old] = glCreateProgram();
+                return;
+            }
+            case OP_ShaderSource: {
+                GLuint shader = map(shaders, r.get<uint32_t>());
+                int count = r.get<int32_t>();
+                std::vector<std::string> src(count);
+                std::vector<const GLchar*> ptrs(count);
+                for (int i = 0; i < count; i++) {
+                    src[i] = r.str();
+                    ptrs[i] = src[i].c_str();
+                }
+                glShaderSource(shader, count, ptrs.data(), nullptr);
+                return;
+            }
+            case OP_GetUniformLocation: {
+                GLuint old = r.get<uint32_t>();
+                std::string name = r.str();
+                GLint oldLoc = r.get<int32_t>();
+                if (oldLoc >= 0) locations[key(old, oldLoc)] = glGetUniformLocation(map(programs, old), name.c_str());
+                return;
+            }
+            case OP_GetUniformBlockIndex: {
+                GLuint old = r.get<uint32_t>();
+                std::string name = r.str();
+                GLuint oldIndex = r.get<uint32_t>();
+                if (oldIndex != GL_INVALID_INDEX) {
+                    blockIndices[key(old, oldIndex)] = glGetUniformBlockIndex(map(programs, old), name.c_str());
+                }
+                return;
+            }
+            case OP_Uniform1fv:
+            case OP_Uniform3fv:
+            case OP_Uniform4fv: {
+                GLint loc = location(r.get<int32_t>());
+                GLsizei count = r.get<int32_t>();
+                const GLfloat* v = (const GLfloat*)r.bytes();
+                if (rec.op == OP_Uniform1fv) glUniform1fv(loc, count, v);
+                if (rec.op == OP_Uniform3fv) glUniform3fv(loc, count, v);
+                if (rec.op == OP_Uniform4fv) glUniform4fv(loc, count, v);
+                return;
+            }
+            case OP_UniformMatrix4fv: {
+                GLint loc = location(r.get<int32_t>());
+                GLsizei count = r.get<int32_t>();
+                GLboolean transpose = r.get<uint8_t>();
+                glUniformMatrix4fv(loc, count, transpose, (const GLfloat*)r.bytes());
+                return;
+            }
+            case OP_BufferData: {
+                GLenum target = r.get<uint32_t>();
+                GLsizeiptr size = (GLsizeiptr)r.get<int64_t>();
+                const void* data = r.bytes();
+                GLenum usage = r.get<uint32_t>();
+                glBufferData(target, size, data, usage);
+                return;
+            }
+            case OP_BufferSubData: {
+                GLenum target = r.get<uint32_t>();
+                GLintptr offset = (GLintptr)r.get<int64_t>();
+                GLsizeiptr size = (GLsizeiptr)r.get<int64_t>();
+                glBufferSubData(target, offset, size, r.bytes());
+                return;
+            }
+            case OP_TexImage2D: {
+                GLenum target = r.get<uint32_t>();
+                GLint level = r.get<int32_t>();
+                GLint internal = r.get<int32_t>();
+                GLsizei w = r.get<int32_t>();
+                GLsizei h = r.get<int32_t>();
+                GLint border = r.get<int32_t>();
+                GLenum format = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                glTexImage2D(target, level, internal, w, h, border, format, type, r.bytes());
+                return;
+            }
+            case OP_TexSubImage2D: {
+                GLenum target = r.get<uint32_t>();
+                GLint level = r.get<int32_t>();
+                GLint x = r.get<int32_t>();
+                GLint y = r.get<int32_t>();
+                GLsizei w = r.get<int32_t>();
+                GLsizei h = r.get<int32_t>();
+                GLenum format = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                glTexSubImage2D(target, level, x, y, w, h, format, type, r.bytes());
+                return;
+            }
+            case OP_TexImage3D: {
+                GLenum target = r.get<uint32_t>();
+                GLint level = r.get<int32_t>();
+                GLint internal = r.get<int32_t>();
+                GLsizei w = r.get<int32_t>();
+                GLsizei h = r.get<int32_t>();
+                GLsizei d = r.get<int32_t>();
+                GLint border = r.get<int32_t>();
+                GLenum format = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                glTexImage3D(target, level, internal, w, h, d, border, format, type, r.bytes());
+                return;
+            }
+            case OP_TexSubImage3D: {
+                GLenum target = r.get<uint32_t>();
+                GLint level = r.get<int32_t>();
+                GLint x = r.get<int32_t>();
+                GLint y = r.get<int32_t>();
+                GLint z = r.get<int32_t>();
+                GLsizei w = r.get<int32_t>();
+                GLsizei h = r.get<int32_t>();
+                GLsizei d = r.get<int32_t>();
+                GLenum format = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                glTexSubImage3D(target, level, x, y, z, w, h, d, format, type, r.bytes());
+                return;
+            }
+            case OP_PixelStorei: {
+                GLenum pname = r.get<uint32_t>();
+                glPixelStorei(pname, r.get<int32_t>());
+                return;
+            }
+            case OP_FenceSync: {
+                GLenum condition = r.get<uint32_t>();
+                GLbitfield flags = r.get<uint32_t>();
+                syncs[r.get<uint64_t>()] = glFenceSync(condition, flags);
+                return;
+            }
+            case OP_ClientWaitSync: {
+                GLsync s = sync(r.get<uint64_t>());
+                GLbitfield flags = r.get<uint32_t>();
+                GLuint64 timeout = r.get<uint64_t>();
+                if (s) glClientWaitSync(s, flags, timeout);
+                return;
+            }
+            case OP_DeleteSync: {
+                uint64_t old = r.get<uint64_t>();
+                GLsync s = sync(old);
+                if (s) glDeleteSync(s);
+                syncs.erase(old);
+                return;
+            }
+            case OP_MultiDrawElements: {
+                GLenum mode = r.get<uint32_t>();
+                GLenum type = r.get<uint32_t>();
+                GLsizei drawcount = r.get<int32_t>();
+                std::vector<GLsizei> counts(drawcount);
+                std::vector<const void*> offsets(drawcount);
+                for (GLsizei i = 0; i < drawcount; i++) {
+                    counts[i] = r.get<int32_t>();
+                    offsets[i] = (const void*)(uintptr_t)r.get<uint64_t>();
+                }
+                glMultiDrawElements(mode, counts.data(), type, offsets.data(), drawcount);
+                return;
+            }
+        }
+
+        std::cerr << "GL trace: unknown op " << rec.op << std::endl;
+    }
+
+private:
+    std::vector<unsigned char> file;
+
+    typedef std::unordered_map<GLuint, GLuint> NameMap;
+    typedef gltrace::GenFn GenFnPtr;
+    typedef gltrace::DeleteFn DeleteFnPtr;
+    NameMap buffers, textures, framebuffers, renderbuffers, vertexArrays, programs, shaders;
+    std::unordered_map<uint64_t, GLint> locations;
+    std::unordered_map<uint64_t, GLuint> blockIndices;
+    std::unordered_map<uint64_t, GLsync> syncs;
+    GLuint currentProgram = 0;   // capture-side names
+    GLuint firstProgram = 0;
+
+    static uint64_t key(GLuint program, GLuint v) {
+        return ((uint64_t)program << 32) | v;
+    }
+
+    static GLuint map(const NameMap& m, GLuint old) {
+        if (old == 0) return 0;
+        NameMap::const_iterator it = m.find(old);
+        return it == m.end() ? old : it->second;
+    }
+
+    GLint location(GLint old) {
+        if (old < 0) return old;
+        std::unordered_map<uint64_t, GLint>::const_iterator it = locations.find(key(currentProgram, old));
+        return it == locations.end() ? -1 : it->second;
+    }
+
+    GLsync sync(uint64_t old) {
+        std::unordered_map<uint64_t, GLsync>::const_iterator it = syncs.find(old);
+        return it == syncs.end() ? nullptr : it->second;
+    }
+
+    template <typename T>
+    T remap(T v, char kind) {
+        if constexpr (std::is_integral_v<T>) {
+            switch (kind) {
+                case 'b': return (T)map(buffers, (GLuint)v);
+                case 't': return (T)map(textures, (GLuint)v);
+                case 'f': return v == 0 ? (T)defaultFramebuffer : (T)map(framebuffers, (GLuint)v);
+                case 'r': return (T)map(renderbuffers, (GLuint)v);
+                case 'v': return (T)map(vertexArrays, (GLuint)v);
+                case 'p': return (T)map(programs, (GLuint)v);
+                case 's': return (T)map(shaders, (GLuint)v);
+                case 'l': return (T)location((GLint)v);
+                case 'k': {
+                    std::unordered_map<uint64_t, GLuint>::const_iterator it = blockIndices.find(key(firstProgram, (GLuint)v));
+                    return it == blockIndices.end() ? v : (T)it->second;
+                }
+            }
+        }
+        return v;
+    }
+
+    template <typename R, typename... A, size_t... I>
+    void callSimple(R (APIENTRYP fn)(A...), const char* kinds, std::tuple<A...>& args, std::index_sequence<I...>) {
+        fn(remap(std::get<I>(args), kinds[I])...);
+    }
+
+    template <typename R, typename... A>
+    void playSimple(R (APIENTRYP fn)(A...), const char* kinds, gltrace::Reader& r) {
+        // braced init evaluates left to right
+        std::tuple<A...> args{ r.arg<A>()... };
+
+        // block indices and UseProgram need the capture-side program name
+        if constexpr (sizeof...(A) > 0) {
+            if (kinds[0] == 'p') firstProgram = (GLuint)std::get<0>(args);
+        }
+
+        callSimple(fn, kinds, args, std::index_sequence_for<A...>());
+    }
+
+    void gen(gltrace::Reader& r, GenFnPtr fn, NameMap& m) {
+        int n = r.get<int32_t>();
+        for (int i = 0; i < n; i++) {
+            GLuint old = r.get<uint32_t>();
+            GLuint name = 0;
+            fn(1, &name);
+            m[old] = name;
+        }
+    }
+
+    void del(gltrace::Reader& r, DeleteFnPtr fn, NameMap& m) {
+        int n = r.get<int32_t>();
+        for (int i = 0; i < n; i++) {
+            GLuint old = r.get<uint32_t>();
+            NameMap::iterator it = m.find(old);
+            if (it == m.end()) continue;
+            fn(1, &it->second);
+            m.erase(it);
+        }
+    }
+
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+#include <glad/glad.h>
+
+// GPU duration of a span of commands from a pair of GL_TIMESTAMP queries.
+// results arrive a few frames late; poll() only returns what is already
+// available and never waits. timestamps (unlike GL_TIME_ELAPSED) may
+// overlap and nest, so several timers can be live at once.
+//
+//   timer.begin(frame); ...draws...; timer.end();
+//   double ms; unsigned long long f;
+//   while (timer.poll(ms, f)) { ... }
+class GpuTimer {
+public:
+    static const int LATENCY = 4;   // spans in flight before results get dropped
+
+    // last value poll() returned
+    double lastMs = 0.0;
+
+    GpuTimer() {
+        glGenQueries(LATENCY * 2, queries);
+    }
+
+    ~GpuTimer() {
+        glDeleteQueries(LATENCY * 2, queries);
+    }
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin(unsigned long long frame) {
+        // the GPU is LATENCY spans behind, drop the oldest
+        if (written - read >= LATENCY) read++;
+
+        int slot = (int)(written % LATENCY);
+        frames[slot] = frame;
+        glQueryCounter(queries[slot * 2], GL_TIMESTAMP);
+        open = true;
+    }
+
+    void end() {
+        if (!open) return;
+
+        int slot = (int)(written % LATENCY);
+        glQueryCounter(queries[slot * 2 + 1], GL_TIMESTAMP);
+        written++;
+        open = false;
+    }
+
+    // oldest finished span, false if none is ready yet
+    bool poll(double& ms, unsigned long long& frame) {
+        if (read == written) return false;
+
+        int slot = (int)(read % LATENCY);
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(queries[slot * 2], GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(queries[slot * 2 + 1], GL_QUERY_RESULT, &t1);
+
+        ms = lastMs = (t1 - t0) / 1e6;
+        frame = frames[slot];
+        read++;
+        return true;
+    }
+
+    // drain everything available, keeps the newest in lastMs
+    bool pollLatest() {
+        double ms;
+        unsigned long long frame;
+        bool any = false;
+        while (poll(ms, frame)) any = true;
+        return any;
+    }
+
+private:
+    GLuint queries[LATENCY * 2] = {};
+    unsigned long long frames[LATENCY] = {};
+    unsigned long long written = 0;
+    unsigned long long read = 0;
+    bool open = false;
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include <iostream>
+#include "MemoryRegistry.h"
 
 class MSAA_FBO {
 public:
@@ -14,6 +15,9 @@ public:
     GLuint fbo_resolve = 0;
     GLuint tex_resolved = 0;
 
+    // format of depth_msaa, anything blitting depth out of it must match
+    GLenum depthFormat = GL_DEPTH24_STENCIL8;
+
     MSAA_FBO(int w, int h, int s) {
         width = w;
         height = h;
@@ -31,6 +35,14 @@ public:
         create();
     }
 
+    // GL_DEPTH24_STENCIL8, or GL_DEPTH32F_STENCIL8 for reverse-Z
+    void setDepthFormat(GLenum format) {
+        if (format == depthFormat) return;
+        depthFormat = format;
+        destroy();
+        create();
+    }
+
     void create() {
         // multisample fbo
         glGenFramebuffers(1, &fbo_msaa);
@@ -39,13 +51,13 @@ public:
         // color
         glGenRenderbuffers(1, &color_msaa);
         glBindRenderbuffer(GL_RENDERBUFFER, color_msaa);
-        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+        MemoryRegistry::get().renderbufferStorage("msaa color", color_msaa, samples, GL_RGBA8, width, height);
         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_msaa);
 
         // depth
         glGenRenderbuffers(1, &depth_msaa);
         glBindRenderbuffer(GL_RENDERBUFFER, depth_msaa);
-        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH24_STENCIL8, width, height);
+        MemoryRegistry::get().renderbufferStorage("msaa depth", depth_msaa, samples, depthFormat, width, height);
         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_msaa);
 
         if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
@@ -58,8 +70,8 @@ public:
 
         glGenTextures(1, &tex_resolved);
         glBindTexture(GL_TEXTURE_2D, tex_resolved);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        MemoryRegistry::get().texImage2D("msaa resolve", GL_TEXTURE_2D, tex_resolved, 0, GL_RGBA8,
+                                         width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -76,6 +88,11 @@ public:
     }
 
     void destroy() {
+        MemoryRegistry& mem = MemoryRegistry::get();
+        mem.release(MemoryRegistry::RENDERBUFFER, color_msaa);
+        mem.release(MemoryRegistry::RENDERBUFFER, depth_msaa);
+        mem.release(MemoryRegistry::TEXTURE, tex_resolved);
+
         if (color_msaa) glDeleteRenderbuffers(1, &color_msaa);
         if (depth_msaa) glDeleteRenderbuffers(1, &depth_msaa);
         if (fbo_msaa) glDeleteFramebuffers(1, &fbo_msaa);
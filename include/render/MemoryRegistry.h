@@ -0,0 +1,360 @@
+#pragma once
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+// bookkeeping for GPU allocations and CPU memory used while loading.
+//
+// GL allocation sites call the wrappers below instead of glBufferData /
+// glTexImage2D / glRenderbufferStorage*, which issue the call and record
+// type, dimensions, format, samples and an estimated byte size. sizes are
+// the logical size of the storage; drivers add padding (RGB is usually
+// stored as RGBX), mip tails and compression metadata on top.
+//
+// loaders open a LoadScope and report their transient CPU buffers with
+// cpuAlloc/cpuFree, the scope keeps the peak.
+class MemoryRegistry {
+public:
+    enum Type { BUFFER, TEXTURE, RENDERBUFFER, TYPE_COUNT };
+
+    struct Entry {
+        Type type = BUFFER;
+        GLuint name = 0;
+        std::string label;
+        GLenum target = 0;
+        GLenum format = 0;
+        int width = 0, height = 0, layers = 0;
+        int samples = 0;
+        size_t bytes = 0;
+
+        // per (face target, level), so re-specifying an image replaces it
+        std::map<std::pair<GLenum, int>, size_t> images;
+    };
+
+    struct LoadRecord {
+        std::string label;
+        size_t peakBytes = 0;
+        double seconds = 0.0;
+    };
+
+    static MemoryRegistry& get() {
+        static MemoryRegistry registry;
+        return registry;
+    }
+
+    // --- GPU ---
+
+    // glBufferData on the buffer currently bound to target
+    void bufferData(const std::string& label, GLenum target, GLuint buffer,
+                    GLsizeiptr size, const void* data, GLenum usage) {
+        glBufferData(target, size, data, usage);
+        trackBuffer(label, target, buffer, (size_t)size);
+    }
+
+    // for storage made some other way (glBufferStorage, orphaning)
+    void trackBuffer(const std::string& label, GLenum target, GLuint buffer, size_t size) {
+        Entry& e = entry(BUFFER, buffer, label);
+        e.target = target;
+        e.width = (int)size;
+        e.bytes = size;
+        updatePeak();
+    }
+
+    // glTexImage2D on the texture currently bound; cube faces and mip
+    // levels accumulate on the same entry
+    void texImage2D(const std::string& label, GLenum target, GLuint texture, GLint level,
+                    GLint internalFormat, GLsizei w, GLsizei h,
+                    GLenum format, GLenum type, const void* data) {
+        glTexImage2D(target, level, internalFormat, w, h, 0, format, type, data);
+
+        Entry& e = entry(TEXTURE, texture, label);
+        bool face = target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z;
+
+        e.target = face ? GL_TEXTURE_CUBE_MAP : target;
+        e.format = (GLenum)internalFormat;
+        if (level == 0) {
+            e.width = w;
+            e.height = h;
+        }
+
+        e.images[std::make_pair(target, (int)level)] = (size_t)w * h * formatBytes((GLenum)internalFormat);
+        e.layers = 0;
+        e.bytes = 0;
+        for (const auto& img : e.images) {
+            if (img.first.second == 0) e.layers++;
+            e.bytes += img.second;
+        }
+        updatePeak();
+    }
+
+    // glTexImage3D on the texture array currently bound, depth = layers.
+    // mip levels accumulate on the same entry
+    void texImage3D(const std::string& label, GLenum target, GLuint texture, GLint level,
+                    GLint internalFormat, GLsizei w, GLsizei h, GLsizei depth,
+                    GLenum format, GLenum type, const void* data) {
+        glTexImage3D(target, level, internalFormat, w, h, depth, 0, format, type, data);
+
+        Entry& e = entry(TEXTURE, texture, label);
+        e.target = target;
+        e.format = (GLenum)internalFormat;
+        if (level == 0) {
+            e.width = w;
+            e.height = h;
+            e.layers = depth;
+        }
+
+        e.images[std::make_pair(target, (int)level)] = (size_t)w * h * depth * formatBytes((GLenum)internalFormat);
+        e.bytes = 0;
+        for (const auto& img : e.images) e.bytes += img.second;
+        updatePeak();
+    }
+
+    // glRenderbufferStorageMultisample on the renderbuffer currently bound,
+    // samples 0 is a plain single-sampled renderbuffer
+    void renderbufferStorage(const std::string& label, GLuint renderbuffer, GLsizei samples,
+                             GLenum internalFormat, GLsizei w, GLsizei h) {
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internalFormat, w, h);
+
+        Entry& e = entry(RENDERBUFFER, renderbuffer, label);
+        e.target = GL_RENDERBUFFER;
+        e.format = internalFormat;
+        e.width = w;
+        e.height = h;
+        e.layers = 1;
+        e.samples = samples;
+        e.bytes = (size_t)w * h * formatBytes(internalFormat) * std::max(1, (int)samples);
+        updatePeak();
+    }
+
+    // call next to the matching glDelete*
+    void release(Type type, GLuint name) {
+        if (!name) return;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].type == type && entries[i].name == name) {
+                entries.erase(entries.begin() + i);
+                return;
+            }
+        }
+    }
+
+    size_t total(Type type) const {
+        size_t sum = 0;
+        for (const Entry& e : entries) {
+            if (e.type == type) sum += e.bytes;
+        }
+        return sum;
+    }
+
+    size_t total() const {
+        size_t sum = 0;
+        for (const Entry& e : entries) sum += e.bytes;
+        return sum;
+    }
+
+    size_t peakGpuBytes() const {
+        return gpuPeak;
+    }
+
+    const std::vector<Entry>& all() const {
+        return entries;
+    }
+
+    // --- CPU during load ---
+
+    class LoadScope {
+    public:
+        explicit LoadScope(const std::string& label)
+            : start(std::chrono::steady_clock::now()) {
+            MemoryRegistry& r = MemoryRegistry::get();
+            outer = r.scope;
+            r.scope = this;
+            record.label = label;
+        }
+
+        ~LoadScope() {
+            MemoryRegistry& r = MemoryRegistry::get();
+            record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            r.loads.push_back(record);
+            r.scope = outer;
+
+            // a nested load's buffers were live inside the outer one too
+            if (outer) outer->record.peakBytes = std::max(outer->record.peakBytes, outer->current + record.peakBytes);
+        }
+
+        LoadScope(const LoadScope&) = delete;
+        LoadScope& operator=(const LoadScope&) = delete;
+
+    private:
+        friend class MemoryRegistry;
+        LoadRecord record;
+        LoadScope* outer = nullptr;
+        size_t current = 0;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // transient CPU buffers (decoded images, parsed files, staging vectors)
+    void cpuAlloc(size_t bytes) {
+        if (!scope) return;
+        scope->current += bytes;
+        scope->record.peakBytes = std::max(scope->record.peakBytes, scope->current);
+    }
+
+    void cpuFree(size_t bytes) {
+        if (!scope) return;
+        scope->current -= std::min(bytes, scope->current);
+    }
+
+    const std::vector<LoadRecord>& loadHistory() const {
+        return loads;
+    }
+
+    // --- report ---
+
+    // totals, the `top` largest allocations and the load peaks
+    std::string report(size_t top = 10) const {
+        std::vector<const Entry*> sorted;
+        for (const Entry& e : entries) sorted.push_back(&e);
+        std::sort(sorted.begin(), sorted.end(), [](const Entry* a, const Entry* b) {
+            return a->bytes > b->bytes;
+        });
+
+        std::ostringstream s;
+        s << std::fixed << std::setprecision(2);
+        s << "GPU memory: " << mb(total()) << " MB in " << entries.size() << " allocations (peak "
+          << mb(gpuPeak) << " MB)\n";
+        s << "  buffers " << mb(total(BUFFER)) << " MB, textures " << mb(total(TEXTURE))
+          << " MB, renderbuffers " << mb(total(RENDERBUFFER)) << " MB\n";
+
+        for (size_t i = 0; i < sorted.size() && i < top; i++) {
+            const Entry& e = *sorted[i];
+            s << "  " << std::setw(9) << mb(e.bytes) << " MB  " << std::left << std::setw(13) << typeName(e)
+              << std::setw(24) << e.label << std::right;
+
+            if (e.type == BUFFER) {
+                s << e.bytes << " bytes";
+            } else {
+                s << e.width << "x" << e.height;
+                if (e.layers > 1) s << "x" << e.layers;
+                s << " " << formatName(e.format);
+                if (e.samples > 1) s << " " << e.samples << "x";
+            }
+            s << "\n";
+        }
+
+        if (!loads.empty()) {
+            s << "CPU peak during load:\n";
+            for (const LoadRecord& l : loads) {
+                s << "  " << std::setw(9) << mb(l.peakBytes) << " MB  " << std::left << std::setw(37) << l.label
+                  << std::right << l.seconds * 1000.0 << " ms\n";
+            }
+        }
+        return s.str();
+    }
+
+    // logical bytes per pixel of an internal format, 4 if unknown
+    static size_t formatBytes(GLenum f) {
+        switch (f) {
+            case GL_R8: case GL_RED: return 1;
+            case GL_RG8: case GL_RG: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+            case GL_RGB8: case GL_RGB: case GL_SRGB8: return 3;
+            case GL_RGBA8: case GL_RGBA: case GL_SRGB8_ALPHA8: case GL_R32F: case GL_RG16F:
+            case GL_R11F_G11F_B10F: case GL_RGB10_A2:
+            case GL_DEPTH24_STENCIL8: case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32F: return 4;
+            case GL_RGB16F: return 6;
+            case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: return 8;
+            case GL_RGB32F: return 12;
+            case GL_RGBA32F: return 16;
+            default: return 4;
+        }
+    }
+
+    static const char* formatName(GLenum f) {
+        switch (f) {
+            case GL_R8: return "R8";
+            case GL_RED: return "RED";
+            case GL_RG8: return "RG8";
+            case GL_RGB8: return "RGB8";
+            case GL_RGB: return "RGB";
+            case GL_SRGB8: return "SRGB8";
+            case GL_RGBA8: return "RGBA8";
+            case GL_RGBA: return "RGBA";
+            case GL_SRGB8_ALPHA8: return "SRGB8_A8";
+            case GL_R32F: return "R32F";
+            case GL_RGB16F: return "RGB16F";
+            case GL_RGBA16F: return "RGBA16F";
+            case GL_RGBA32F: return "RGBA32F";
+            case GL_DEPTH24_STENCIL8: return "D24S8";
+            case GL_DEPTH32F_STENCIL8: return "D32FS8";
+            case GL_DEPTH_COMPONENT24: return "D24";
+            case GL_DEPTH_COMPONENT32F: return "D32F";
+            default: return "?";
+        }
+    }
+
+private:
+    std::vector<Entry> entries;
+    std::vector<LoadRecord> loads;
+    LoadScope* scope = nullptr;
+    size_t gpuPeak = 0;
+
+    MemoryRegistry() {}
+
+    Entry& entry(Type type, GLuint name, const std::string& label) {
+        Entry* found = nullptr;
+        for (Entry& e : entries) {
+            if (e.type == type && e.name == name) found = &e;
+        }
+
+        if (!found) {
+            entries.emplace_back();
+            found = &entries.back();
+            found->type = type;
+            found->name = name;
+        }
+
+        found->label = label;
+        return *found;
+    }
+
+    // called after an entry grew
+    void updatePeak() {
+        gpuPeak = std::max(gpuPeak, total());
+    }
+
+    static double mb(size_t bytes) {
+        return bytes / (1024.0 * 1024.0);
+    }
+
+    static const char* typeName(const Entry& e) {
+        if (e.type == BUFFER) return e.target == GL_ELEMENT_ARRAY_BUFFER ? "index buf" : "buffer";
+        if (e.type == RENDERBUFFER) return "renderbuffer";
+        if (e.target == GL_TEXTURE_2D_ARRAY) return "tex array";
+        return e.target == GL_TEXTURE_CUBE_MAP ? "cubemap" : "texture";
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,491 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include "MSAA.h"
+#include "MemoryRegistry.h"
+
+// occlusion culling for the objects drawn after the occluder depth pre-pass.
+//
+//   QUERY        bounding boxes are tested with occlusion queries after the
+//                pre-pass, results are read one frame late and only if
+//                already available. a missing result keeps the last answer.
+//   CONDITIONAL  same queries, but every draw is wrapped in a no-wait
+//                conditional render on this frame's query. the GPU decides,
+//                the CPU reads results one frame late for stats only.
+//   HIZ          CPU path for comparison: the pre-pass depth is read back
+//                through a PBO, turned into a max-depth pyramid on the next
+//                frame and the boxes are tested against it. reverse-Z depth
+//                is flipped on the way in, the pyramid is always 1 = far.
+//
+// one-frame-late answers can pop in a frame late when things move fast.
+// occlusion queries are not part of GL traces, a replay draws everything.
+class OcclusionCuller {
+public:
+    enum Mode { OFF, QUERY, CONDITIONAL, HIZ, MODE_COUNT };
+
+    struct Box {
+        glm::vec3 min, max;
+    };
+
+    Mode mode = OFF;
+
+    // last frame
+    int tested = 0;
+    int culled = 0;
+    double cpuMs = 0.0;     // cull() time, includes the pyramid build
+
+    OcclusionCuller() {
+        queryTarget = GL_ANY_SAMPLES_PASSED;
+#ifdef GL_ANY_SAMPLES_PASSED_CONSERVATIVE
+        if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_ES3_compatibility) queryTarget = GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+#endif
+        createBox();
+    }
+
+    ~OcclusionCuller() {
+        for (int s = 0; s < 2; s++) {
+            if (!queries[s].empty()) glDeleteQueries((GLsizei)queries[s].size(), queries[s].data());
+        }
+        destroyHiZ();
+
+        MemoryRegistry::get().release(MemoryRegistry::BUFFER, boxVBO);
+        MemoryRegistry::get().release(MemoryRegistry::BUFFER, boxEBO);
+        if (boxVAO) glDeleteVertexArrays(1, &boxVAO);
+        if (boxVBO) glDeleteBuffers(1, &boxVBO);
+        if (boxEBO) glDeleteBuffers(1, &boxEBO);
+    }
+
+    static const char* modeName(int m) {
+        switch (m) {
+            case OFF: return "off";
+            case QUERY: return "query";
+            case CONDITIONAL: return "cond";
+            case HIZ: return "hiz";
+            default: return "?";
+        }
+    }
+
+    const char* queryName() const {
+        return queryTarget == GL_ANY_SAMPLES_PASSED ? "ANY_SAMPLES_PASSED" : "ANY_SAMPLES_PASSED_CONSERVATIVE";
+    }
+
+    void setMode(Mode m) {
+        mode = m;
+        std::fill(lastVisible.begin(), lastVisible.end(), 1);
+        for (int s = 0; s < 2; s++) std::fill(issued[s].begin(), issued[s].end(), 0);
+        hizValid = false;
+    }
+
+    // decide what to draw this frame from results that are already there,
+    // never waits on the GPU. eye is the camera position.
+    void cull(const std::vector<Box>& boxes, const glm::vec3& eye, std::vector<char>& visible) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+        size_t n = boxes.size();
+        resize(n);
+        visible.assign(n, 1);
+        tested = culled = 0;
+
+        if (mode == QUERY || mode == CONDITIONAL) {
+            int prev = (frame + 1) & 1;
+
+            for (size_t i = 0; i < n; i++) {
+                if (issued[prev][i]) {
+                    GLuint available = 0;
+                    glGetQueryObjectuiv(queries[prev][i], GL_QUERY_RESULT_AVAILABLE, &available);
+                    if (available) {
+                        GLuint passed = 0;
+                        glGetQueryObjectuiv(queries[prev][i], GL_QUERY_RESULT, &passed);
+                        lastVisible[i] = passed ? 1 : 0;
+                        issued[prev][i] = 0;
+                    }
+                }
+
+                if (contains(boxes[i], eye)) lastVisible[i] = 1;
+
+                tested++;
+                if (!lastVisible[i]) culled++;
+
+                // conditional render draws everything and lets the GPU skip
+                if (mode == QUERY) visible[i] = lastVisible[i];
+            }
+        } else if (mode == HIZ) {
+            readBackHiZ();
+
+            for (size_t i = 0; i < n; i++) {
+                if (!hizValid) break;
+                tested++;
+                if (!contains(boxes[i], eye) && hizOccluded(boxes[i])) {
+                    visible[i] = 0;
+                    culled++;
+                }
+            }
+        }
+
+        cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // test boxes against the depth in the bound framebuffer, call after the
+    // occluder pre-pass. program draws occlusion_box.vert
+    void issueQueries(const std::vector<Box>& boxes, const glm::vec3& eye, GLuint program) {
+        if (mode != QUERY && mode != CONDITIONAL) return;
+
+        int cur = frame & 1;
+        resize(boxes.size());
+
+        if (program != boxProgram) {
+            boxProgram = program;
+            locMin = glGetUniformLocation(program, "boxMin");
+            locMax = glGetUniformLocation(program, "boxMax");
+        }
+
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glUseProgram(program);
+        glBindVertexArray(boxVAO);
+
+        for (size_t i = 0; i < boxes.size(); i++) {
+            // the near plane would clip the box away, treat as visible
+            if (contains(boxes[i], eye)) {
+                issued[cur][i] = 0;
+                continue;
+            }
+
+            glBeginQuery(queryTarget, queries[cur][i]);
+            glUniform3fv(locMin, 1, &boxes[i].min.x);
+            glUniform3fv(locMax, 1, &boxes[i].max.x);
+            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, 0);
+            glEndQuery(queryTarget);
+            issued[cur][i] = 1;
+        }
+
+        glBindVertexArray(0);
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    // CONDITIONAL: wrap the draw of object i
+    void beginConditional(size_t i) {
+        conditionalOpen = mode == CONDITIONAL && i < issued[frame & 1].size() && issued[frame & 1][i];
+        if (conditionalOpen) glBeginConditionalRender(queries[frame & 1][i], GL_QUERY_NO_WAIT);
+    }
+
+    void endConditional() {
+        if (conditionalOpen) glEndConditionalRender();
+        conditionalOpen = false;
+    }
+
+    // HIZ: copy the pre-pass depth out of the MSAA target and start an
+    // async readback. leaves fbo.fbo_msaa bound. reverseZ / zeroToOne as
+    // in Camera, for how viewProj maps to the depth buffer
+    void captureDepth(const MSAA_FBO& fbo, const glm::mat4& viewProj, bool reverseZ = false, bool zeroToOne = false) {
+        if (mode != HIZ) return;
+
+        if (fbo.width != depthW || fbo.height != depthH || fbo.depthFormat != depthFormat) {
+            destroyHiZ();
+            createHiZ(fbo.width, fbo.height, fbo.depthFormat);
+        }
+
+        int cur = frame & 1;
+        if (pboFence[cur]) {
+            // the previous readback from this slot was never consumed
+            glDeleteSync(pboFence[cur]);
+            pboFence[cur] = 0;
+        }
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo.fbo_msaa);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, depthFBO);
+        glBlitFramebuffer(0, 0, depthW, depthH, 0, 0, depthW, depthH, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, depthFBO);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[cur]);
+        glReadPixels(0, 0, depthW, depthH, GL_DEPTH_COMPONENT, GL_FLOAT, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        pboFence[cur] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pboViewProj[cur] = viewProj;
+        pboReverseZ[cur] = reverseZ;
+        pboZeroToOne[cur] = zeroToOne;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo.fbo_msaa);
+    }
+
+    void endFrame() {
+        frame++;
+    }
+
+private:
+    GLenum queryTarget = GL_ANY_SAMPLES_PASSED;
+    std::vector<GLuint> queries[2];
+    std::vector<char> issued[2];
+    std::vector<char> lastVisible;
+    unsigned long long frame = 0;
+    bool conditionalOpen = false;
+
+    GLuint boxVAO = 0, boxVBO = 0, boxEBO = 0;
+    GLuint boxProgram = 0;
+    GLint locMin = -1, locMax = -1;
+
+    // hi-z
+    static const int HIZ_BASE_SHIFT = 2;    // level 0 is 1/4 of the framebuffer
+    GLuint depthFBO = 0, depthRB = 0;
+    GLuint pbo[2] = {};
+    GLsync pboFence[2] = {};
+    glm::mat4 pboViewProj[2];
+    bool pboReverseZ[2] = {}, pboZeroToOne[2] = {};
+    int depthW = 0, depthH = 0;
+    GLenum depthFormat = 0;
+
+    struct Level {
+        int w = 0, h = 0;
+        std::vector<float> depth;
+    };
+    std::vector<Level> pyramid;
+    glm::mat4 hizViewProj = glm::mat4(1.0f);
+    bool hizReverseZ = false, hizZeroToOne = false;
+    bool hizValid = false;
+
+    void resize(size_t n) {
+        if (lastVisible.size() >= n) return;
+
+        for (int s = 0; s < 2; s++) {
+            size_t old = queries[s].size();
+            queries[s].resize(n);
+            glGenQueries((GLsizei)(n - old), queries[s].data() + old);
+            issued[s].resize(n, 0);
+        }
+        lastVisible.resize(n, 1);
+    }
+
+    static bool contains(const Box& b, const glm::vec3& p) {
+        const float pad = 0.05f;    // near plane distance plus a bit
+        return p.x > b.min.x - pad && p.y > b.min.y - pad && p.z > b.min.z - pad &&
+               p.x < b.max.x + pad && p.y < b.max.y + pad && p.z < b.max.z + pad;
+    }
+
+    void createBox() {
+        const float verts[] = {
+            0,0,0,  1,0,0,  1,1,0,  0,1,0,
+            0,0,1,  1,0,1,  1,1,1,  0,1,1
+        };
+        const unsigned char idx[] = {
+            0,2,1, 0,3,2,   4,5,6, 4,6,7,
+            0,1,5, 0,5,4,   3,6,2, 3,7,6,
+            0,4,7, 0,7,3,   1,2,6, 1,6,5
+        };
+
+        glGenVertexArrays(1, &boxVAO);
+        glGenBuffers(1, &boxVBO);
+        glGenBuffers(1, &boxEBO);
+
+        glBindVertexArray(boxVAO);
+
+        glBindBuffer(GL_ARRAY_BUFFER, boxVBO);
+        MemoryRegistry::get().bufferData("occlusion box", GL_ARRAY_BUFFER, boxVBO, sizeof(verts), verts, GL_STATIC_DRAW);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, boxEBO);
+        MemoryRegistry::get().bufferData("occlusion box idx", GL_ELEMENT_ARRAY_BUFFER, boxEBO, sizeof(idx), idx, GL_STATIC_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+
+        glBindVertexArray(0);
+    }
+
+    void createHiZ(int w, int h, GLenum format) {
+        depthW = w;
+        depthH = h;
+        depthFormat = format;
+
+        MemoryRegistry& mem = MemoryRegistry::get();
+
+        glGenFramebuffers(1, &depthFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, depthFBO);
+
+        glGenRenderbuffers(1, &depthRB);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthRB);
+        mem.renderbufferStorage("hiz depth copy", depthRB, 0, format, w, h);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRB);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "HiZ FBO incomplete!" << std::endl;
+        }
+
+        glGenBuffers(2, pbo);
+        for (int i = 0; i < 2; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+            mem.bufferData("hiz readback", GL_PIXEL_PACK_BUFFER, pbo[i], (GLsizeiptr)w * h * sizeof(float),
+                           nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        hizValid = false;
+    }
+
+    void destroyHiZ() {
+        MemoryRegistry& mem = MemoryRegistry::get();
+
+        for (int i = 0; i < 2; i++) {
+            if (pboFence[i]) glDeleteSync(pboFence[i]);
+            pboFence[i] = 0;
+            mem.release(MemoryRegistry::BUFFER, pbo[i]);
+        }
+        mem.release(MemoryRegistry::RENDERBUFFER, depthRB);
+
+        if (pbo[0]) glDeleteBuffers(2, pbo);
+        if (depthRB) glDeleteRenderbuffers(1, &depthRB);
+        if (depthFBO) glDeleteFramebuffers(1, &depthFBO);
+
+        pbo[0] = pbo[1] = depthRB = depthFBO = 0;
+        depthW = depthH = 0;
+        hizValid = false;
+    }
+
+    // map last frame's readback if the GPU is done with it and rebuild
+    // the pyramid, otherwise keep the old one
+    void readBackHiZ() {
+        int prev = (frame + 1) & 1;
+        if (!pboFence[prev]) return;
+
+        GLenum r = glClientWaitSync(pboFence[prev], 0, 0);
+        if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) return;
+
+        glDeleteSync(pboFence[prev]);
+        pboFence[prev] = 0;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[prev]);
+        const float* depth = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+            (GLsizeiptr)depthW * depthH * sizeof(float), GL_MAP_READ_BIT);
+
+        if (depth) {
+            buildPyramid(depth, pboReverseZ[prev]);
+            hizViewProj = pboViewProj[prev];
+            hizReverseZ = pboReverseZ[prev];
+            hizZeroToOne = pboZeroToOne[prev];
+            hizValid = true;
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    // max-depth pyramid, level 0 reduces 4x4 framebuffer pixels
+    void buildPyramid(const float* depth, bool reverseZ) {
+        int step = 1 << HIZ_BASE_SHIFT;
+        int w = (depthW + step - 1) / step;
+        int h = (depthH + step - 1) / step;
+
+        pyramid.resize(1);
+        Level& base = pyramid[0];
+        base.w = w;
+        base.h = h;
+        base.depth.assign((size_t)w * h, 0.0f);
+
+        for (int y = 0; y < depthH; y++) {
+            const float* row = depth + (size_t)y * depthW;
+            float* dst = &base.depth[(size_t)(y / step) * w];
+            for (int x = 0; x < depthW; x++) {
+                float& d = dst[x / step];
+                d = std::max(d, reverseZ ? 1.0f - row[x] : row[x]);
+            }
+        }
+
+        while (w > 1 || h > 1) {
+            const Level& src = pyramid.back();
+            Level next;
+            next.w = std::max(1, (w + 1) / 2);
+            next.h = std::max(1, (h + 1) / 2);
+            next.depth.resize((size_t)next.w * next.h);
+
+            for (int y = 0; y < next.h; y++) {
+                for (int x = 0; x < next.w; x++) {
+                    int x0 = x * 2, y0 = y * 2;
+                    int x1 = std::min(x0 + 1, w - 1), y1 = std::min(y0 + 1, h - 1);
+                    next.depth[(size_t)y * next.w + x] = std::max(
+                        std::max(src.depth[(size_t)y0 * w + x0], src.depth[(size_t)y0 * w + x1]),
+                        std::max(src.depth[(size_t)y1 * w + x0], src.depth[(size_t)y1 * w + x1]));
+                }
+            }
+
+            pyramid.push_back(std::move(next));
+            w = pyramid.back().w;
+            h = pyramid.back().h;
+        }
+    }
+
+    static int pixel(float ndc, int size) {
+        int p = (int)((ndc * 0.5f + 0.5f) * size);
+        return std::min(std::max(p, 0), size - 1);
+    }
+
+    bool hizOccluded(const Box& b) const {
+        float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+
+        for (int c = 0; c < 8; c++) {
+            glm::vec3 p((c & 1) ? b.max.x : b.min.x, (c & 2) ? b.max.y : b.min.y, (c & 4) ? b.max.z : b.min.z);
+            glm::vec4 clip = hizViewProj * glm::vec4(p, 1.0f);
+
+            // crosses the near plane, no usable screen rect
+            if (clip.w <= 1e-5f) return false;
+
+            glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            minX = std::min(minX, ndc.x);
+            maxX = std::max(maxX, ndc.x);
+            minY = std::min(minY, ndc.y);
+            maxY = std::max(maxY, ndc.y);
+            float z = hizZeroToOne ? ndc.z : ndc.z * 0.5f + 0.5f;
+            minZ = std::min(minZ, hizReverseZ ? 1.0f - z : z);
+        }
+
+        // off screen counts as culled, the query path sees zero samples too
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) return true;
+
+        // framebuffer pixels first, then level 0 texels
+        int x0 = pixel(minX, depthW) >> HIZ_BASE_SHIFT, x1 = pixel(maxX, depthW) >> HIZ_BASE_SHIFT;
+        int y0 = pixel(minY, depthH) >> HIZ_BASE_SHIFT, y1 = pixel(maxY, depthH) >> HIZ_BASE_SHIFT;
+
+        // coarsest level where the rect spans at most 2 texels per axis
+        size_t level = 0;
+        while (level + 1 < pyramid.size() && std::max(x1 - x0, y1 - y0) > 1) {
+            x0 >>= 1; y0 >>= 1; x1 >>= 1; y1 >>= 1;
+            level++;
+        }
+
+        const Level& l = pyramid[level];
+        float maxDepth = 0.0f;
+        for (int y = y0; y <= std::min(y1, l.h - 1); y++) {
+            for (int x = x0; x <= std::min(x1, l.w - 1); x++) {
+                maxDepth = std::max(maxDepth, l.depth[(size_t)y * l.w + x]);
+            }
+        }
+
+        return minZ > maxDepth;
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <iostream>
+#include "MemoryRegistry.h"
+
+// asynchronous color readback through a ring of pixel pack buffers.
+// read() only queues the copy and fences it; collect() maps whatever the
+// GPU has finished, so readback overlaps with rendering the next frames.
+// the CPU only blocks when all SLOTS are still in flight.
+class PboReadback {
+public:
+    static const int SLOTS = 4;
+
+    int width = 0, height = 0;
+
+    // stats
+    unsigned long long stalls = 0;  // read() or collect(wait) had to block
+
+    PboReadback(int w, int h) : width(w), height(h) {
+        glGenBuffers(SLOTS, pbo);
+        for (int i = 0; i < SLOTS; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+            MemoryRegistry::get().bufferData("readback pbo", GL_PIXEL_PACK_BUFFER, pbo[i], frameBytes(),
+                                             nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    ~PboReadback() {
+        for (int i = 0; i < SLOTS; i++) {
+            if (fences[i]) glDeleteSync(fences[i]);
+            MemoryRegistry::get().release(MemoryRegistry::BUFFER, pbo[i]);
+        }
+        glDeleteBuffers(SLOTS, pbo);
+    }
+
+    PboReadback(const PboReadback&) = delete;
+    PboReadback& operator=(const PboReadback&) = delete;
+
+    size_t frameBytes() const {
+        return (size_t)width * height * 4;
+    }
+
+    // queue an RGBA8 copy of color attachment 0 of fbo. sink is only
+    // needed when the ring is full and the oldest slot has to be drained
+    template <typename Sink>
+    void read(GLuint fbo, unsigned long long frame, Sink&& sink) {
+        if (pending == SLOTS) {
+            stalls++;
+            drainOldest(true, sink);
+        }
+
+        int slot = (int)(written % SLOTS);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[slot]);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+        fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        frames[slot] = frame;
+        written++;
+        pending++;
+    }
+
+    // hand finished frames to sink(frame, const unsigned char* rgba) in
+    // order. with wait, blocks until everything queued is delivered.
+    // the pointer is only valid during the call, rows are bottom-up
+    template <typename Sink>
+    void collect(bool wait, Sink&& sink) {
+        while (pending > 0) {
+            if (!drainOldest(wait, sink)) break;
+        }
+    }
+
+private:
+    GLuint pbo[SLOTS] = {};
+    GLsync fences[SLOTS] = {};
+    unsigned long long frames[SLOTS] = {};
+    unsigned long long written = 0;
+    int pending = 0;
+
+    template <typename Sink>
+    bool drainOldest(bool wait, Sink&& sink) {
+        int slot = (int)((written - pending) % SLOTS);
+
+        GLenum r = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (r == GL_TIMEOUT_EXPIRED) {
+            if (!wait) return false;
+            while (r == GL_TIMEOUT_EXPIRED) {
+                r = glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            }
+        }
+
+        glDeleteSync(fences[slot]);
+        fences[slot] = 0;
+        pending--;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[slot]);
+        const unsigned char* data = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                                           frameBytes(), GL_MAP_READ_BIT);
+        if (data) {
+            sink(frames[slot], data);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            std::cerr << "PboReadback: map failed" << std::endl;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return true;
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
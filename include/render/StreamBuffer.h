@@ -0,0 +1,263 @@
+#pragma once
+#include <glad/glad.h>
+#include <iostream>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include "MemoryRegistry.h"
+
+// ring buffer for per-frame streaming data (uniforms, instance transforms,
+// dynamic vertices). one GL buffer split into FRAMES regions, each region
+// guarded by a fence so the CPU never writes what the GPU is still reading.
+//
+// persistent mode: ARB_buffer_storage, mapped once for the whole lifetime.
+// fallback mode:   allocations land in a CPU shadow and flush() copies them
+//                  in with MAP_UNSYNCHRONIZED; if the region is still busy
+//                  the buffer is orphaned instead of waiting on the fence.
+//
+// call flush() after writing and before issuing draws that read the data.
+class StreamBuffer {
+public:
+    static const int FRAMES = 3;
+
+    struct Allocation {
+        void* ptr = nullptr;
+        GLintptr offset = 0;
+        size_t size = 0;
+    };
+
+    GLuint buffer = 0;
+    size_t regionSize = 0;
+    size_t size = 0;
+    bool persistent = false;
+
+    // stats
+    unsigned int stallsThisFrame = 0;
+    unsigned int stallsLastFrame = 0;
+    unsigned int orphansLastFrame = 0;
+    unsigned long long totalStalls = 0;
+    size_t bytesThisFrame = 0;
+    size_t bytesLastFrame = 0;
+
+    StreamBuffer(size_t bytesPerFrame, bool allowPersistent = true) {
+        GLint align = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+        uboAlign = align > 0 ? (size_t)align : 256;
+
+        regionSize = alignUp(bytesPerFrame, uboAlign);
+        size = regionSize * FRAMES;
+        create(allowPersistent);
+    }
+
+    ~StreamBuffer() {
+        destroy();
+    }
+
+    // advance to the next region and make it writable
+    void beginFrame() {
+        stallsLastFrame = stallsThisFrame;
+        orphansLastFrame = orphansThisFrame;
+        bytesLastFrame = bytesThisFrame;
+        stallsThisFrame = orphansThisFrame = 0;
+        bytesThisFrame = 0;
+
+        region = (region + 1) % FRAMES;
+        head = flushed = 0;
+
+        if (persistent) {
+            waitRegion(region);
+            mapped = base + region * regionSize;
+        } else {
+            mapped = shadow.data();
+        }
+    }
+
+    // bump allocate from the current region. align defaults to the UBO
+    // offset alignment so any allocation can back a uniform block.
+    Allocation alloc(size_t bytes, size_t align = 0) {
+        Allocation a;
+        if (!mapped) return a;
+
+        size_t start = alignUp(head, align ? align : uboAlign);
+        if (start + bytes > regionSize) {
+            if (!overflowWarned) {
+                std::cerr << "StreamBuffer: region overflow (" << start + bytes
+                          << " > " << regionSize << " bytes)" << std::endl;
+                overflowWarned = true;
+            }
+            return a;
+        }
+
+        head = start + bytes;
+        bytesThisFrame += bytes;
+
+        a.ptr = mapped + start;
+        a.offset = (GLintptr)(region * regionSize + start);
+        a.size = bytes;
+        return a;
+    }
+
+    // make allocations written so far visible to the GPU. coherent
+    // persistent mappings need nothing, the fallback copies the new part
+    // of the shadow into the region.
+    void flush() {
+        if (persistent || head == flushed) return;
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        if (flushed == 0 && !regionIdle(region)) {
+            // don't block, hand the old storage to the driver instead
+            glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            for (int i = 0; i < FRAMES; i++) releaseFence(i);
+            orphansThisFrame++;
+        }
+
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, region * regionSize + flushed, head - flushed,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+        if (dst) {
+            memcpy(dst, shadow.data() + flushed, head - flushed);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            std::cerr << "StreamBuffer: map failed" << std::endl;
+        }
+
+        flushed = head;
+    }
+
+    // fence the region, nothing may be allocated until the next beginFrame
+    void endFrame() {
+        flush();
+        mapped = nullptr;
+
+        releaseFence(region);
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    const char* modeName() const {
+        return persistent ? "persistent" : "orphan";
+    }
+
+private:
+    unsigned char* base = nullptr;
+    unsigned char* mapped = nullptr;
+    std::vector<unsigned char> shadow;
+    GLsync fences[FRAMES] = {};
+    int region = FRAMES - 1;
+    size_t head = 0;
+    size_t flushed = 0;
+    size_t uboAlign = 256;
+    unsigned int orphansThisFrame = 0;
+    bool overflowWarned = false;
+
+    static size_t alignUp(size_t v, size_t a) {
+        return (v + a - 1) / a * a;
+    }
+
+    static bool hasBufferStorage() {
+#ifdef GL_ARB_buffer_storage
+        return GLAD_GL_ARB_buffer_storage || GLAD_GL_VERSION_4_4;
+#else
+        return false;
+#endif
+    }
+
+    void create(bool allowPersistent) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+#ifdef GL_ARB_buffer_storage
+        if (allowPersistent && hasBufferStorage()) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+            base = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+            persistent = base != nullptr;
+        }
+#endif
+
+        if (!persistent) {
+            // immutable storage can't be orphaned, start over with a mutable buffer
+            if (allowPersistent && hasBufferStorage()) {
+                glDeleteBuffers(1, &buffer);
+                glGenBuffers(1, &buffer);
+                glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            }
+            glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            shadow.resize(regionSize);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        MemoryRegistry::get().trackBuffer("stream ring", GL_ARRAY_BUFFER, buffer, size);
+
+        std::cout << "StreamBuffer: " << (size >> 10) << " KB, " << modeName() << " mode\n";
+    }
+
+    void destroy() {
+        for (int i = 0; i < FRAMES; i++) releaseFence(i);
+
+        if (buffer) {
+            MemoryRegistry::get().release(MemoryRegistry::BUFFER, buffer);
+            if (persistent) {
+                glBindBuffer(GL_ARRAY_BUFFER, buffer);
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            }
+            glDeleteBuffers(1, &buffer);
+        }
+
+        buffer = 0;
+        base = mapped = nullptr;
+    }
+
+    void releaseFence(int i) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+    }
+
+    bool regionIdle(int i) {
+        if (!fences[i]) return true;
+
+        GLenum r = glClientWaitSync(fences[i], 0, 0);
+        if (r == GL_ALREADY_SIGNALED || r == GL_CONDITION_SATISFIED) {
+            releaseFence(i);
+            return true;
+        }
+        return false;
+    }
+
+    void waitRegion(int i) {
+        if (regionIdle(i)) return;
+
+        // the GPU is more than FRAMES-1 frames behind, we have to block
+        stallsThisFrame++;
+        totalStalls++;
+
+        while (true) {
+            GLenum r = glClientWaitSync(fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            if (r != GL_TIMEOUT_EXPIRED) break;
+        }
+        releaseFence(i);
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+#include <glad/glad.h>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include "MemoryRegistry.h"
+
+// RGBA8 images packed into GL_TEXTURE_2D_ARRAY pools, one pool per size
+// and format (sRGB color or linear data), so every texture is a (pool,
+// layer) pair. all pools stay bound on consecutive texture units and the
+// shader picks the layer per fragment: switching textures costs no bind.
+// past MAX_POOLS, the smallest groups are resampled into the biggest pool
+// of their format.
+class TexturePools {
+public:
+    static const int MAX_POOLS = 8;
+
+    struct Image {
+        int width = 0, height = 0;
+        bool srgb = false;
+        const unsigned char* rgba = nullptr;
+    };
+
+    struct Slot {
+        int pool = -1, layer = -1;  // -1: not placed
+    };
+
+    struct Pool {
+        GLuint tex = 0;
+        int width = 0, height = 0;
+        bool srgb = false;
+        int layers = 0;
+    };
+
+    std::vector<Pool> pools;
+
+    TexturePools() {}
+
+    ~TexturePools() {
+        clear();
+    }
+
+    TexturePools(const TexturePools&) = delete;
+    TexturePools& operator=(const TexturePools&) = delete;
+
+    // pool and layer of every image, without touching GL. images past
+    // maxLayers of a pool are left out
+    static std::vector<Slot> plan(const std::vector<Image>& images, int maxLayers, std::vector<Pool>& out) {
+        typedef std::tuple<bool, int, int> Key;    // srgb, width, height
+        std::map<Key, std::vector<int>> groups;
+        for (int i = 0; i < (int)images.size(); i++) {
+            const Image& img = images[i];
+            if (img.rgba && img.width > 0 && img.height > 0) groups[Key(img.srgb, img.width, img.height)].push_back(i);
+        }
+
+        // merge the group with the fewest images into the largest group of
+        // the same format. there are only two formats, so this always ends
+        while ((int)groups.size() > MAX_POOLS) {
+            auto from = groups.end();
+            for (auto it = groups.begin(); it != groups.end(); ++it) {
+                if (largest(groups, std::get<0>(it->first), it->first) == groups.end()) continue;
+                if (from == groups.end() || it->second.size() < from->second.size()) from = it;
+            }
+
+            auto to = largest(groups, std::get<0>(from->first), from->first);
+            to->second.insert(to->second.end(), from->second.begin(), from->second.end());
+            groups.erase(from);
+        }
+
+        std::vector<Slot> slots(images.size());
+        out.clear();
+        for (const auto& g : groups) {
+            Pool p;
+            p.srgb = std::get<0>(g.first);
+            p.width = std::get<1>(g.first);
+            p.height = std::get<2>(g.first);
+
+            for (int i : g.second) {
+                if (p.layers == maxLayers) break;
+                slots[i].pool = (int)out.size();
+                slots[i].layer = p.layers++;
+            }
+            out.push_back(p);
+        }
+        return slots;
+    }
+
+    // creates the pools, uploads every image and builds the mip chains
+    std::vector<Slot> build(const std::vector<Image>& images) {
+        clear();
+
+        GLint maxLayers = 256;
+        glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+        std::vector<Slot> slots = plan(images, maxLayers, pools);
+        for (size_t i = 0; i < images.size(); i++) {
+            if (images[i].rgba && slots[i].pool < 0) {
+                std::cerr << "TexturePools: over " << maxLayers << " layers, image " << i << " left out" << std::endl;
+            }
+        }
+
+        MemoryRegistry& mem = MemoryRegistry::get();
+        std::vector<unsigned char> scratch;
+
+        for (size_t p = 0; p < pools.size(); p++) {
+            Pool& pool = pools[p];
+            GLenum format = pool.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+            std::string label = std::string("material pool ") + (pool.srgb ? "srgb " : "") +
+                                std::to_string(pool.width) + "x" + std::to_string(pool.height);
+
+            glGenTextures(1, &pool.tex);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, pool.tex);
+
+            // every level up front, so the registry sees the whole chain
+            for (int level = 0, w = pool.width, h = pool.height;; level++) {
+                mem.texImage3D(label, GL_TEXTURE_2D_ARRAY, pool.tex, level, format, w, h, pool.layers,
+                               GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                if (w == 1 && h == 1) break;
+                w = std::max(w / 2, 1);
+                h = std::max(h / 2, 1);
+            }
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            for (size_t i = 0; i < images.size(); i++) {
+                if (slots[i].pool != (int)p) continue;
+
+                const Image& img = images[i];
+                const unsigned char* src = img.rgba;
+                if (img.width != pool.width || img.height != pool.height) {
+                    scratch.resize((size_t)pool.width * pool.height * 4);
+                    Resample(img.rgba, img.width, img.height, scratch.data(), pool.width, pool.height);
+                    src = scratch.data();
+                }
+
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, slots[i].layer, pool.width, pool.height, 1,
+                                GL_RGBA, GL_UNSIGNED_BYTE, src);
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+            // wrap modes differ per texture and are applied in the shader
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        return slots;
+    }
+
+    // pool i on unit firstUnit + i
+    void bind(int firstUnit) const {
+        for (size_t i = 0; i < pools.size(); i++) {
+            glActiveTexture(GL_TEXTURE0 + firstUnit + (GLenum)i);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, pools[i].tex);
+        }
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void clear() {
+        for (Pool& p : pools) {
+            MemoryRegistry::get().release(MemoryRegistry::TEXTURE, p.tex);
+            glDeleteTextures(1, &p.tex);
+        }
+        pools.clear();
+    }
+
+    // bilinear, only used for the odd image that lost its own pool
+    static void Resample(const unsigned char* src, int sw, int sh, unsigned char* dst, int dw, int dh) {
+        for (int y = 0; y < dh; y++) {
+            float fy = std::max((y + 0.5f) * sh / dh - 0.5f, 0.0f);
+            int y0 = std::min((int)fy, sh - 1), y1 = std::min(y0 + 1, sh - 1);
+            float ty = fy - y0;
+
+            for (int x = 0; x < dw; x++) {
+                float fx = std::max((x + 0.5f) * sw / dw - 0.5f, 0.0f);
+                int x0 = std::min((int)fx, sw - 1), x1 = std::min(x0 + 1, sw - 1);
+                float tx = fx - x0;
+
+                const unsigned char* a = src + ((size_t)y0 * sw + x0) * 4;
+                const unsigned char* b = src + ((size_t)y0 * sw + x1) * 4;
+                const unsigned char* c = src + ((size_t)y1 * sw + x0) * 4;
+                const unsigned char* d = src + ((size_t)y1 * sw + x1) * 4;
+                unsigned char* o = dst + ((size_t)y * dw + x) * 4;
+
+                for (int k = 0; k < 4; k++) {
+                    float top = a[k] + (b[k] - a[k]) * tx;
+                    float bottom = c[k] + (d[k] - c[k]) * tx;
+                    o[k] = (unsigned char)(top + (bottom - top) * ty + 0.5f);
+                }
+            }
+        }
+    }
+
+private:
+    // biggest group (by area) of a format other than skip
+    template <typename Groups, typename Key>
+    static typename Groups::iterator largest(Groups& groups, bool srgb, const Key& skip) {
+        auto best = groups.end();
+        for (auto it = groups.begin(); it != groups.end(); ++it) {
+            if (std::get<0>(it->first) != srgb || it->first == skip) continue;
+
+            long long area = (long long)std::get<1>(it->first) * std::get<2>(it->first);
+            if (best == groups.end() || area > (long long)std::get<1>(best->first) * std::get<2>(best->first)) best = it;
+        }
+        return best;
+    }
+};
@@ -0,0 +1,430 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <tiny_gltf.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include "scenegraph.h"
+
+// glTF skins and animations. one Skeleton and its clips are shared by
+// every character; CrowdAnimator holds the per-character state and
+// evaluates all characters in one go, joint by joint, so the inner loops
+// run over characters with the same channel and the same parent.
+
+// float components of accessor index, normalized integers are converted
+// as the glTF spec says and plain integers (joint indices) keep their value
+inline bool ReadAccessorFloats(const tinygltf::Model& m, int index, int components, std::vector<float>& out) {
+    if (index < 0 || index >= (int)m.accessors.size()) return false;
+
+    const tinygltf::Accessor& a = m.accessors[index];
+    if (a.bufferView < 0 || a.bufferView >= (int)m.bufferViews.size()) return false;
+
+    const tinygltf::BufferView& view = m.bufferViews[a.bufferView];
+    if (view.buffer < 0 || view.buffer >= (int)m.buffers.size()) return false;
+
+    const std::vector<unsigned char>& data = m.buffers[view.buffer].data;
+    if (view.byteOffset > data.size() || view.byteLength > data.size() - view.byteOffset) return false;
+
+    int stride = a.ByteStride(view);
+    if (stride <= 0) return false;
+
+    // every element inside the view. count <= byteLength keeps the
+    // product from overflowing
+    size_t element = (size_t)components * tinygltf::GetComponentSizeInBytes(a.componentType);
+    if (a.count > view.byteLength || a.byteOffset > view.byteLength) return false;
+    if (a.count && (a.count - 1) * (size_t)stride + element > view.byteLength - a.byteOffset) return false;
+
+    const unsigned char* src = data.data() + view.byteOffset + a.byteOffset;
+    out.resize(a.count * components);
+
+    for (size_t i = 0; i < a.count; i++) {
+        const unsigned char* e = src + i * stride;
+        float* dst = &out[i * components];
+
+        for (int c = 0; c < components; c++) {
+            switch (a.componentType) {
+                case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+                    memcpy(&dst[c], e + c * 4, 4);
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                    dst[c] = a.normalized ? e[c] / 255.0f : (float)e[c];
+                    break;
+                case TINYGLTF_COMPONENT_TYPE_BYTE:
+                    dst[c] = a.normalized ? std::max((signed char)e[c] / 127.0f, -1.0f) : (float)(signed char)e[c];
+                    break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+                    unsigned short v;
+                    memcpy(&v, e + c * 2, 2);
+                    dst[c] = a.normalized ? v / 65535.0f : (float)v;
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_SHORT: {
+                    short v;
+                    memcpy(&v, e + c * 2, 2);
+                    dst[c] = a.normalized ? std::max(v / 32767.0f, -1.0f) : (float)v;
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct AnimationClip {
+    enum Path { TRANSLATION, ROTATION, SCALE };
+    enum Interpolation { STEP, LINEAR, CUBICSPLINE };
+
+    struct Channel {
+        int slot;               // skeleton slot
+        Path path;
+        Interpolation interpolation;
+        int keys;
+        int timeOffset;         // first key in times
+        int valueOffset;        // first float in values
+    };
+
+    std::string name;
+    float duration = 0.0f;
+    std::vector<Channel> channels;
+    std::vector<float> times;
+    std::vector<float> values;  // cubic spline keys are in-tangent, value, out-tangent
+};
+
+// every node a skin or animation touches plus their ancestors, in scene
+// graph order so parents come first. the rest of the graph doesn't move
+// per character and isn't evaluated
+class Skeleton {
+public:
+    std::vector<int> node;              // graph index per slot
+    std::vector<int> parent;            // slot, -1 for roots
+    std::vector<glm::vec3> restT, restS;
+    std::vector<glm::quat> restR;
+
+    std::vector<int> jointSlot;         // per skin joint
+    std::vector<glm::mat4> inverseBind; // per skin joint
+
+    int slots() const {
+        return (int)node.size();
+    }
+
+    int jointCount() const {
+        return (int)jointSlot.size();
+    }
+
+    int slotOf(int graphNode) const {
+        return graphNode >= 0 && graphNode < (int)slotOfNode.size() ? slotOfNode[graphNode] : -1;
+    }
+
+    // skin may be -1 for files that only animate nodes
+    bool build(const tinygltf::Model& m, const SceneGraph& g, int skin) {
+        *this = Skeleton();
+
+        std::vector<int> graphOf(m.nodes.size(), -1);
+        for (int i = 0; i < g.count(); i++) {
+            if (g.source[i] >= 0 && graphOf[g.source[i]] < 0) graphOf[g.source[i]] = i;
+        }
+
+        std::vector<char> include(g.count(), 0);
+        auto add = [&](int gltfNode) {
+            if (gltfNode < 0 || gltfNode >= (int)graphOf.size() || graphOf[gltfNode] < 0) return false;
+            for (int i = graphOf[gltfNode]; i >= 0 && !include[i]; i = g.parent[i]) include[i] = 1;
+            return true;
+        };
+
+        const tinygltf::Skin* s = skin >= 0 && skin < (int)m.skins.size() ? &m.skins[skin] : nullptr;
+        if (s) {
+            for (int j : s->joints) {
+                if (!add(j)) return false;   // joint outside the scene
+            }
+        }
+        for (const tinygltf::Animation& a : m.animations) {
+            for (const tinygltf::AnimationChannel& c : a.channels) add(c.target_node);
+        }
+
+        slotOfNode.assign(g.count(), -1);
+        for (int i = 0; i < g.count(); i++) {
+            if (!include[i]) continue;
+
+            slotOfNode[i] = slots();
+            node.push_back(i);
+            parent.push_back(g.parent[i] >= 0 ? slotOfNode[g.parent[i]] : -1);
+            restT.push_back(g.translation[i]);
+            restR.push_back(g.rotation[i]);
+            restS.push_back(g.scale[i]);
+        }
+
+        if (!s) return true;
+
+        for (int j : s->joints) jointSlot.push_back(slotOfNode[graphOf[j]]);
+
+        inverseBind.assign(s->joints.size(), glm::mat4(1.0f));
+        std::vector<float> ibm;
+        if (s->inverseBindMatrices >= 0) {
+            if (!ReadAccessorFloats(m, s->inverseBindMatrices, 16, ibm) || ibm.size() < s->joints.size() * 16) return false;
+            for (size_t j = 0; j < s->joints.size(); j++) memcpy(&inverseBind[j][0][0], &ibm[j * 16], sizeof(glm::mat4));
+        }
+        return true;
+    }
+
+    // every animation of the file, channels outside the skeleton and morph
+    // weights are dropped
+    bool loadClips(const tinygltf::Model& m, const SceneGraph& g, std::vector<AnimationClip>& clips) const {
+        clips.clear();
+
+        std::vector<int> graphOf(m.nodes.size(), -1);
+        for (int i = 0; i < g.count(); i++) {
+            if (g.source[i] >= 0 && graphOf[g.source[i]] < 0) graphOf[g.source[i]] = i;
+        }
+
+        std::vector<float> input, output;
+        for (const tinygltf::Animation& a : m.animations) {
+            AnimationClip clip;
+            clip.name = a.name;
+
+            for (const tinygltf::AnimationChannel& c : a.channels) {
+                if (c.sampler < 0 || c.sampler >= (int)a.samplers.size()) continue;
+                if (c.target_node < 0 || c.target_node >= (int)graphOf.size()) continue;
+
+                int slot = slotOf(graphOf[c.target_node]);
+                if (slot < 0) continue;
+
+                AnimationClip::Channel ch;
+                ch.slot = slot;
+                if (c.target_path == "translation") ch.path = AnimationClip::TRANSLATION;
+                else if (c.target_path == "rotation") ch.path = AnimationClip::ROTATION;
+                else if (c.target_path == "scale") ch.path = AnimationClip::SCALE;
+                else continue;
+
+                const tinygltf::AnimationSampler& s = a.samplers[c.sampler];
+                if (s.interpolation == "STEP") ch.interpolation = AnimationClip::STEP;
+                else if (s.interpolation == "CUBICSPLINE") ch.interpolation = AnimationClip::CUBICSPLINE;
+                else ch.interpolation = AnimationClip::LINEAR;
+
+                int comps = ch.path == AnimationClip::ROTATION ? 4 : 3;
+                int perKey = ch.interpolation == AnimationClip::CUBICSPLINE ? 3 : 1;
+                if (!ReadAccessorFloats(m, s.input, 1, input) || input.empty()) continue;
+                if (!ReadAccessorFloats(m, s.output, comps, output)) continue;
+                if (output.size() != input.size() * comps * perKey) continue;
+
+                ch.keys = (int)input.size();
+                ch.timeOffset = (int)clip.times.size();
+                ch.valueOffset = (int)clip.values.size();
+                clip.times.insert(clip.times.end(), input.begin(), input.end());
+                clip.values.insert(clip.values.end(), output.begin(), output.end());
+                clip.duration = std::max(clip.duration, input.back());
+                clip.channels.push_back(ch);
+            }
+
+            if (!clip.channels.empty()) clips.push_back(std::move(clip));
+        }
+        return !clips.empty();
+    }
+
+private:
+    std::vector<int> slotOfNode;
+};
+
+// pose and world matrices of many characters playing clips of one
+// skeleton. arrays are slot-major, [slot * characters + character].
+// characters are independent, big crowds are split across threads
+class CrowdAnimator {
+public:
+    // below this many joints x characters evaluate() stays on the calling thread
+    static const int PARALLEL_MIN_JOINTS = 4096;
+
+    int characters = 0;
+
+    // stats of the last evaluate()
+    float cpuMs = 0.0f;
+
+    void resize(const Skeleton& sk, int count) {
+        characters = count;
+        size_t n = (size_t)sk.slots() * count;
+        t.resize(n);
+        r.resize(n);
+        s.resize(n);
+        world.resize(n);
+        wrapped.resize(count);
+        resetPose(sk);
+    }
+
+    // sample clip at a time per character (seconds, wrapped to the clip
+    // length), then world matrices of every slot. with palettes, also the
+    // joint matrices for skinning, character after character, 3 rows of the
+    // 3x4 matrix per joint (12 floats) as the skinned shaders fetch them.
+    // threads = 0 uses every core
+    void evaluate(const Skeleton& sk, const AnimationClip& clip, const float* times,
+                  float* palettes = nullptr, int threads = 0) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+        if (&clip != lastClip) {
+            resetPose(sk);      // paths the new clip doesn't animate go back to rest
+            lastClip = &clip;
+        }
+
+        if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, characters);
+        if (threads <= 1 || characters * sk.slots() < PARALLEL_MIN_JOINTS) {
+            evaluateRange(sk, clip, times, palettes, 0, characters);
+        } else {
+            WorkerPool::get().run(threads, [&](int i) {
+                evaluateRange(sk, clip, times, palettes, characters * i / threads, characters * (i + 1) / threads);
+            });
+        }
+
+        cpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // one character's animated nodes into the graph, for files without a
+    // skin where the animation moves whole nodes
+    void applyToGraph(const Skeleton& sk, const AnimationClip& clip, SceneGraph& g, int character) const {
+        for (const AnimationClip::Channel& ch : clip.channels) {
+            size_t i = (size_t)ch.slot * characters + character;
+            g.setLocal(sk.node[ch.slot], t[i], r[i], s[i]);
+        }
+    }
+
+private:
+    std::vector<glm::vec3> t, s;
+    std::vector<glm::quat> r;
+    std::vector<glm::mat4> world;
+    std::vector<float> wrapped;
+    const AnimationClip* lastClip = nullptr;
+
+    void resetPose(const Skeleton& sk) {
+        for (int slot = 0; slot < sk.slots(); slot++) {
+            size_t base = (size_t)slot * characters;
+            std::fill(t.begin() + base, t.begin() + base + characters, sk.restT[slot]);
+            std::fill(r.begin() + base, r.begin() + base + characters, sk.restR[slot]);
+            std::fill(s.begin() + base, s.begin() + base + characters, sk.restS[slot]);
+        }
+        lastClip = nullptr;
+    }
+
+    void evaluateRange(const Skeleton& sk, const AnimationClip& clip, const float* times,
+                       float* palettes, int begin, int end) {
+        for (int c = begin; c < end; c++) {
+            float tc = clip.duration > 0.0f ? std::fmod(times[c], clip.duration) : 0.0f;
+            wrapped[c] = tc < 0.0f ? tc + clip.duration : tc;
+        }
+
+        for (const AnimationClip::Channel& ch : clip.channels) sampleChannel(clip, ch, begin, end);
+
+        const int N = characters;
+        for (int slot = 0; slot < sk.slots(); slot++) {
+            int p = sk.parent[slot];
+            size_t base = (size_t)slot * N;
+
+            for (int c = begin; c < end; c++) {
+                glm::mat4 local;
+                SceneGraph::composeTRS(t[base + c], r[base + c], s[base + c], local);
+
+                if (p < 0) world[base + c] = local;
+                else SceneGraph::mulAffine(world[(size_t)p * N + c], local, world[base + c]);
+            }
+        }
+
+        if (!palettes) return;
+
+        const int J = sk.jointCount();
+        for (int c = begin; c < end; c++) {
+            for (int j = 0; j < J; j++) {
+                glm::mat4 m;
+                SceneGraph::mulAffine(world[(size_t)sk.jointSlot[j] * N + c], sk.inverseBind[j], m);
+
+                float* row = palettes + ((size_t)c * J + j) * 12;
+                for (int k = 0; k < 3; k++) {
+                    row[k * 4 + 0] = m[0][k];
+                    row[k * 4 + 1] = m[1][k];
+                    row[k * 4 + 2] = m[2][k];
+                    row[k * 4 + 3] = m[3][k];
+                }
+            }
+        }
+    }
+
+    void sampleChannel(const AnimationClip& clip, const AnimationClip::Channel& ch, int begin, int end) {
+        const float* times = &clip.times[ch.timeOffset];
+        const float* values = &clip.values[ch.valueOffset];
+        const int comps = ch.path == AnimationClip::ROTATION ? 4 : 3;
+        const size_t base = (size_t)ch.slot * characters;
+
+        for (int c = begin; c < end; c++) {
+            float tc = wrapped[c];
+            float v[4];
+
+            // k is the last key at or before tc
+            int k = (int)(std::upper_bound(times, times + ch.keys, tc) - times) - 1;
+
+            if (k < 0 || k >= ch.keys - 1) {
+                // before the first or after the last key: clamp
+                int key = k < 0 ? 0 : ch.keys - 1;
+                int at = ch.interpolation == AnimationClip::CUBICSPLINE ? key * 3 + 1 : key;
+                memcpy(v, values + at * comps, comps * sizeof(float));
+            } else {
+                float dt = times[k + 1] - times[k];
+                float u = dt > 0.0f ? (tc - times[k]) / dt : 0.0f;
+
+                switch (ch.interpolation) {
+                    case AnimationClip::STEP:
+                        memcpy(v, values + k * comps, comps * sizeof(float));
+                        break;
+
+                    case AnimationClip::LINEAR: {
+                        const float* a = values + k * comps;
+                        const float* b = values + (k + 1) * comps;
+                        if (ch.path == AnimationClip::ROTATION) {
+                            // nlerp is within 0.1 degrees of slerp for keys less
+                            // than ~36 degrees apart, which is nearly all of them
+                            float d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+                            float sign = d < 0.0f ? -1.0f : 1.0f;
+                            if (d * sign > 0.95f) {
+                                for (int i = 0; i < 4; i++) v[i] = a[i] + (sign * b[i] - a[i]) * u;
+                            } else {
+                                glm::quat q = glm::slerp(glm::quat(a[3], a[0], a[1], a[2]), glm::quat(b[3], b[0], b[1], b[2]), u);
+                                v[0] = q.x; v[1] = q.y; v[2] = q.z; v[3] = q.w;
+                            }
+                        } else {
+                            for (int i = 0; i < comps; i++) v[i] = a[i] + (b[i] - a[i]) * u;
+                        }
+                        break;
+                    }
+
+                    case AnimationClip::CUBICSPLINE: {
+                        // hermite, tangents are scaled by the key interval
+                        const float* p0 = values + (k * 3 + 1) * comps;
+                        const float* m0 = values + (k * 3 + 2) * comps;
+                        const float* m1 = values + ((k + 1) * 3) * comps;
+                        const float* p1 = values + ((k + 1) * 3 + 1) * comps;
+
+                        float u2 = u * u, u3 = u2 * u;
+                        float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f;
+                        float h10 = (u3 - 2.0f * u2 + u) * dt;
+                        float h01 = -2.0f * u3 + 3.0f * u2;
+                        float h11 = (u3 - u2) * dt;
+                        for (int i = 0; i < comps; i++) v[i] = h00 * p0[i] + h10 * m0[i] + h01 * p1[i] + h11 * m1[i];
+                        break;
+                    }
+                }
+            }
+
+            switch (ch.path) {
+                case AnimationClip::TRANSLATION: t[base + c] = glm::vec3(v[0], v[1], v[2]); break;
+                case AnimationClip::SCALE:       s[base + c] = glm::vec3(v[0], v[1], v[2]); break;
+                case AnimationClip::ROTATION:
+                    r[base + c] = glm::normalize(glm::quat(v[3], v[0], v[1], v[2]));
+                    break;
+            }
+        }
+    }
+};
@@ -0,0 +1,221 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+// heap allocations since start, counted by the operator new replacement
+// in newhook.h (and ImGui's allocator, see main.cpp). without that hook
+// linked in the counters stay at zero
+struct AllocationCounter {
+    static inline std::atomic<unsigned long long> count{0};
+    static inline std::atomic<unsigned long long> bytes{0};
+
+    static void add(size_t size) {
+        count.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static unsigned long long now() {
+        return count.load(std::memory_order_relaxed);
+    }
+};
+
+// per-frame linear allocator: reset() at the top of every frame, after
+// that alloc() just bumps an offset. nothing is freed or destructed, so it
+// only takes trivially destructible data that doesn't outlive the frame.
+// main thread only.
+//
+// a frame that doesn't fit spills into heap blocks; the next reset()
+// grows the block to the peak so steady state never touches the heap
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    static FrameArena& get() {
+        static FrameArena arena;
+        return arena;
+    }
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY) {
+        grow(capacity);
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void reset() {
+        size_t total = used + spilled;
+        peak = std::max(peak, total);
+
+        if (!spill.empty()) {
+            spill.clear();
+            size_t c = capacity;
+            while (c < total) c *= 2;
+            grow(c);
+        }
+        used = spilled = 0;
+    }
+
+    void* alloc(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t at = (used + align - 1) & ~(align - 1);
+        if (at + size <= capacity) {
+            used = at + size;
+            return block.get() + at;
+        }
+
+        // full: a block of its own until the next reset
+        spill.emplace_back(new char[size + align]);
+        spilled += size + align;
+        uintptr_t p = (uintptr_t)spill.back().get();
+        return (void*)((p + align - 1) & ~(uintptr_t)(align - 1));
+    }
+
+    template <typename T>
+    T* allocArray(size_t n) {
+        return (T*)alloc(n * sizeof(T), alignof(T));
+    }
+
+    // nul-terminated copy
+    char* copy(const char* s, size_t n) {
+        char* d = (char*)alloc(n + 1, 1);
+        memcpy(d, s, n);
+        d[n] = 0;
+        return d;
+    }
+
+    // printf into the arena
+    const char* format(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        const char* s = vformat(fmt, args);
+        va_end(args);
+        return s;
+    }
+
+    const char* vformat(const char* fmt, va_list args) {
+        va_list again;
+        va_copy(again, args);
+
+        // try the rest of the block first, most lines fit
+        size_t room = capacity - used;
+        int n = vsnprintf(block.get() + used, room, fmt, args);
+        if (n < 0) {
+            va_end(again);
+            return "";
+        }
+
+        char* s;
+        if ((size_t)n < room) {
+            s = block.get() + used;
+            used += n + 1;
+        } else {
+            s = (char*)alloc(n + 1, 1);
+            vsnprintf(s, n + 1, fmt, again);
+        }
+        va_end(again);
+        return s;
+    }
+
+    size_t bytesUsed() const { return used + spilled; }
+    size_t bytesCapacity() const { return capacity; }
+    size_t bytesPeak() const { return std::max(peak, used + spilled); }
+
+private:
+    std::unique_ptr<char[]> block;
+    size_t capacity = 0, used = 0;
+    std::vector<std::unique_ptr<char[]>> spill;
+    size_t spilled = 0, peak = 0;
+
+    void grow(size_t c) {
+        block.reset(new char[c]);
+        capacity = c;
+        spill.reserve(16);
+    }
+};
+
+// fixed storage for up to N long-lived objects of one type, so creating
+// and destroying them (reloads, toggles) never goes to the heap for the
+// objects themselves. create() returns nullptr when every slot is taken
+template <typename T, int N>
+class ObjectPool {
+public:
+    ObjectPool() {
+        for (int i = 0; i < N; i++) next[i] = i + 1;
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool() {
+        for (int i = 0; i < N; i++) {
+            if (live[i]) slot(i)->~T();
+        }
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (head == N) return nullptr;
+
+        int i = head;
+        T* p = new (&storage[i]) T(std::forward<Args>(args)...);
+        head = next[i];
+        live[i] = true;
+        count++;
+        return p;
+    }
+
+    // nullptr is fine, as with delete
+    void destroy(T* p) {
+        if (!p) return;
+
+        int i = (int)((Slot*)p - storage);
+        p->~T();
+        live[i] = false;
+        next[i] = head;
+        head = i;
+        count--;
+    }
+
+    int size() const { return count; }
+    static int capacity() { return N; }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+
+    Slot storage[N];
+    int next[N];
+    bool live[N] = {};
+    int head = 0, count = 0;
+
+    T* slot(int i) { return (T*)&storage[i]; }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
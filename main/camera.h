@@ -1,6 +1,7 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cfloat>
 
 class Camera {
 public:
@@ -12,6 +13,14 @@ public:
     float nearPlane;
     float farPlane;
 
+    // reverse-Z: depth 1 at the near plane falling to 0 at an infinite far
+    // plane (farPlane is ignored). zeroToOne says clip z is 0..w, i.e.
+    // glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE) is active; without it
+    // clip z stays -w..w and the mapping to 0..1 eats most of the float
+    // precision near 0
+    bool reverseZ = false;
+    bool zeroToOne = false;
+
 Camera(float width, float height) {
     position   = glm::vec3(0.0f, -0.5f, 7.0f);
     target     = glm::vec3(0.0f, -0.5f, 0.0f);
@@ -30,7 +39,49 @@ Camera(float width, float height) {
     }
 
     glm::mat4 getProjectionMatrix() const {
-        return glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+        if (!reverseZ) return glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+
+        // infinite far: clip z = near (or 2 near - w), w = -z_eye
+        float f = 1.0f / tanf(glm::radians(fov) * 0.5f);
+        glm::mat4 p(0.0f);
+        p[0][0] = f / aspect;
+        p[1][1] = f;
+        p[2][2] = zeroToOne ? 0.0f : 1.0f;
+        p[2][3] = -1.0f;
+        p[3][2] = zeroToOne ? nearPlane : 2.0f * nearPlane;
+        return p;
+    }
+
+    // clip z / w of the far plane, where the skybox goes
+    float farClipDepth() const {
+        if (!reverseZ) return 1.0f;
+        return zeroToOne ? 0.0f : -1.0f;
+    }
+
+    // world space planes (left, right, bottom, top, near, far), xyz
+    // pointing inwards and normalized, so dot(p.xyz, x) + p.w is a distance.
+    // the infinite far plane of reverse-Z comes out as (0, 0, 0, FLT_MAX),
+    // nothing is behind it
+    void getFrustumPlanes(glm::vec4 planes[6]) const {
+        glm::mat4 t = glm::transpose(getProjectionMatrix() * getViewMatrix());
+        planes[0] = t[3] + t[0];
+        planes[1] = t[3] - t[0];
+        planes[2] = t[3] + t[1];
+        planes[3] = t[3] - t[1];
+
+        if (!reverseZ) {
+            planes[4] = t[3] + t[2];        // -w <= z
+            planes[5] = t[3] - t[2];        // z <= w
+        } else {
+            planes[4] = t[3] - t[2];        // z <= w is the near plane now
+            planes[5] = zeroToOne ? t[2] : t[3] + t[2];
+        }
+
+        for (int i = 0; i < 6; i++) {
+            float len = glm::length(glm::vec3(planes[i]));
+            if (len > 1e-6f * std::fabs(planes[i].w)) planes[i] = planes[i] / len;
+            else planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, FLT_MAX);
+        }
     }
 };
 
@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdlib>
+
+#include "arena.h"
+
+// one console line split into a command name and its arguments. the line
+// is copied into the frame arena and split there, so tokens are also
+// nul-terminated (arg(i).data() is a C string) and live until the next
+// frame's reset
+struct ConsoleCommand {
+    static const int MAX_ARGS = 8;      // further arguments are dropped
+
+    std::string_view name;
+    std::string_view args[MAX_ARGS];
+    int argCount = 0;
+
+    static ConsoleCommand parse(std::string_view line, FrameArena& arena = FrameArena::get()) {
+        ConsoleCommand c;
+        char* text = arena.copy(line.data(), line.size());
+        size_t i = 0, n = line.size();
+
+        while (i < n) {
+            while (i < n && (text[i] == ' ' || text[i] == '\t')) i++;
+            if (i == n) break;
+
+            size_t start = i;
+            while (i < n && text[i] != ' ' && text[i] != '\t') i++;
+            std::string_view token(text + start, i - start);
+            if (i < n) text[i++] = 0;
+
+            if (c.name.empty()) c.name = token;
+            else if (c.argCount < MAX_ARGS) c.args[c.argCount++] = token;
+        }
+        return c;
+    }
+
+    std::string_view arg(int i) const {
+        return i < argCount ? args[i] : std::string_view("");
+    }
+
+    // fallback if missing or not a number
+    int intArg(int i, int fallback) const {
+        if (i >= argCount) return fallback;
+
+        const char* s = args[i].data();
+        char* end = nullptr;
+        long v = strtol(s, &end, 10);
+        return end == s ? fallback : (int)v;
+    }
+};
+
+// everything ExecuteCommand understands, `help` prints this list
+inline const char* const consoleCommands[] = {
+    "anim N",
+    "fpslimit N",
+    "help",
+    "inflight N",
+    "info",
+    "mem [N]",
+    "meshlets on|off",
+    "occl off|query|cond|hiz",
+    "ondemand on|off",
+    "pause",
+    "prepass on|off",
+    "profile N [file]|startup [file]",
+    "reversez on|off",
+    "stats dump [file]|reset|stutter X",
+    "t_grid N",
+    "t_msaa X",
+    "vsync off|on|adaptive",
+};
+
+inline std::string ConsoleHelp() {
+    std::string s = "commands: ";
+    for (size_t i = 0; i < sizeof(consoleCommands) / sizeof(consoleCommands[0]); i++) {
+        if (i) s += ", ";
+        s += consoleCommands[i];
+    }
+    return s;
+}
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
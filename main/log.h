@@ -0,0 +1,127 @@
+#pragma once
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <ctime>
+#include <cstdlib>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include "profiler.h"
+#include "arena.h"
+
+// logfile
+inline std::ofstream logFile;
+
+// echo log lines to stdout/stderr (off for benchmarks and headless runs)
+inline bool logEcho = true;
+
+// timestamp into out, "YYYY-MM-DD HH:MM:SS.mmm"
+inline void FormatTimeStamp(char (&out)[32]) {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+
+    size_t n = strftime(out, sizeof(out), "%Y-%m-%d %H:%M:%S", std::localtime(&time_t));
+    snprintf(out + n, sizeof(out) - n, ".%03d", (int)ms.count());
+}
+
+inline std::string GetCurrentTimeStamp() {
+    char ts[32];
+    FormatTimeStamp(ts);
+    return ts;
+}
+
+// log init
+inline void InitializeLogFile() {
+    std::string filename = "togl_demo_log_" + GetCurrentTimeStamp() + ".txt";
+    std::replace(filename.begin(), filename.end(), ':', '-');
+    std::replace(filename.begin(), filename.end(), ' ', '_');
+
+    logFile.open(filename, std::ios::out | std::ios::app);
+    if (!logFile.is_open()) {
+        std::cerr << "t_error_786: Cannot open log file: " << filename << std::endl;
+        exit(1);
+    }
+
+    logFile << "=== log started at " << GetCurrentTimeStamp() << " ===" << std::endl;
+    logFile.flush();
+}
+
+// generic log. builds no strings, the per-frame paths log through here
+inline void LogToFile(const char* level, const char* message) {
+    PROFILE_SCOPE("LogToFile");
+
+    if (logFile.is_open()) {
+        char ts[32];
+        FormatTimeStamp(ts);
+        logFile << "[" << ts << "] [" << level << "] " << message << std::endl;
+    }
+
+    if (!logEcho) return;
+
+    if (strcmp(level, "ERROR") == 0) {
+        std::cerr << "[" << level << "] " << message << std::endl;
+    } else {
+        std::cout << "[" << level << "] " << message << std::endl;
+    }
+}
+
+inline void LogToFile(const char* level, const std::string& message) {
+    LogToFile(level, message.c_str());
+}
+
+inline void LogInfo(const char* m)    { LogToFile("INFO",    m); }
+inline void LogError(const char* m)   { LogToFile("ERROR",   m); }
+inline void LogWarning(const char* m) { LogToFile("WARNING", m); }
+
+inline void LogInfo(const std::string& m)  { LogToFile("INFO",    m); }
+inline void LogError(const std::string& m) { LogToFile("ERROR",   m); }
+inline void LogWarning(const std::string& m){LogToFile("WARNING", m);}
+
+// printf-style, formatted into the frame arena instead of a std::string
+inline void LogInfof(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    LogToFile("INFO", FrameArena::get().vformat(fmt, args));
+    va_end(args);
+}
+
+inline void LogErrorf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    LogToFile("ERROR", FrameArena::get().vformat(fmt, args));
+    va_end(args);
+}
+
+inline void LogWarningf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    LogToFile("WARNING", FrameArena::get().vformat(fmt, args));
+    va_end(args);
+}
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
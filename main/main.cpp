@@ -14,11 +14,33 @@
 #include <chrono>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cfloat>
+#include <cstdio>
+#include <thread>
+#include <filesystem>
 
 #include "shader.h"
 #include "camera.h"
 #include "model.h"
+#include "log.h"
+#include "console.h"
+#include "stats.h"
+#include "sequence.h"
+#include "redraw.h"
+#include "pacing.h"
+#include "profiler.h"
+#include "arena.h"
+#include "newhook.h"
 #include "render/MSAA.h"
+#include "render/StreamBuffer.h"
+#include "render/GLTrace.h"
+#include "render/MemoryRegistry.h"
+#include "render/Occlusion.h"
+#include "render/GpuTimer.h"
+#include "render/Readback.h"
+#include "render/Offscreen.h"
 
 #include <stb/stb_image.h>
 
@@ -30,9 +52,13 @@
 // global
 GLFWwindow* window = nullptr;
 int g_MSAA = 4;
+int g_Width = 1280, g_Height = 720;     // framebuffer size
 bool showConsole = false;
 float lastTime = 0.0f;
 
+// every shader lives here, reloads and toggles don't touch the heap
+ObjectPool<Shader, 8> shaders;
+
 Shader* phong = nullptr;
 Shader* skyboxShader = nullptr;
 Shader* screenShader = nullptr;
@@ -46,54 +72,85 @@ MSAA_FBO* msaa = nullptr;
 // fullscreen quad
 unsigned int screenVAO = 0, screenVBO = 0;
 
-// logfile
-std::ofstream logFile;
-
-// timestamp
-std::string GetCurrentTimeStamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
-    return ss.str();
-}
-
-// log init
-void InitializeLogFile() {
-    std::string filename = "togl_demo_log_" + GetCurrentTimeStamp() + ".txt";
-    std::replace(filename.begin(), filename.end(), ':', '-');
-    std::replace(filename.begin(), filename.end(), ' ', '_');
-
-    logFile.open(filename, std::ios::out | std::ios::app);
-    if (!logFile.is_open()) {
-        std::cerr << "t_error_786: Cannot open log file: " << filename << std::endl;
-        exit(1);
-    }
-
-    logFile << "=== log started at " << GetCurrentTimeStamp() << " ===" << std::endl;
-    logFile.flush();
-}
-
-// generic log
-void LogToFile(const std::string& level, const std::string& message) {
-    if (logFile.is_open()) {
-        logFile << "[" << GetCurrentTimeStamp() << "] [" << level << "] " << message << std::endl;
-        logFile.flush();
-    }
-
-    if (level == "ERROR") {
-        std::cerr << "[" << level << "] " << message << std::endl;
-    } else {
-        std::cout << "[" << level << "] " << message << std::endl;
-    }
-}
-
-void LogInfo(const std::string& m)  { LogToFile("INFO",    m); }
-void LogError(const std::string& m) { LogToFile("ERROR",   m); }
-void LogWarning(const std::string& m){LogToFile("WARNING", m);}
+// per-frame streaming (uniforms, instance transforms)
+StreamBuffer* stream = nullptr;
+const unsigned int FRAME_UBO_BINDING = 0;
+
+// frame times, GPU side measured over the whole frame
+FrameStats frameStats;
+GpuTimer* gpuFrameTimer = nullptr;
+
+// occlusion culling: the row of the test grid nearest the camera goes
+// into a depth pre-pass, everything behind it is tested
+OcclusionCuller* occlusion = nullptr;
+Shader* depthShader = nullptr;
+Shader* occlusionShader = nullptr;
+
+// skinned variants, palettes are read from the stream buffer through a TBO
+Shader* phongSkinned = nullptr;
+Shader* depthSkinned = nullptr;
+GLuint paletteTex = 0;
+const int PALETTE_TEXTURE_UNIT = 1;
+
+// materials: block binding and the first of the texture pool units. the
+// skybox cubemap doubles as the environment reflected by smooth materials
+const unsigned int MATERIAL_UBO_BINDING = 1;
+const int ENVIRONMENT_TEXTURE_UNIT = 0;
+const int MATERIAL_TEXTURE_UNIT = 2;
+
+// test scene, t_grid N lays out N x N copies of the model
+int g_Grid = 1;
+
+// render on demand: the scene is only redrawn when its key changes.
+// pause freezes rotation and animation, so an idle scene stays idle
+RedrawTracker redraw;
+bool g_Paused = false;
+
+// vsync, frame-rate limit, frames in flight and input latency, see pacing.h
+FramePacer pacer;
+
+// meshlet culling of unskinned models, see meshlet.h
+bool g_Meshlets = true;
+
+// reverse-Z: D32F depth cleared to 0, infinite far plane, GL_GREATER.
+// with clip control the near plane maps to 1 and depth keeps its float
+// precision; without it the -1..1 range halves what reverse-Z gains
+bool g_ReverseZ = false;
+bool g_ClipControl = false;
+
+// full depth pre-pass: every instance depth-only first, then shading with
+// GL_EQUAL so each sample is shaded once. shade time is kept per mode so
+// the console can put the two side by side
+bool g_DepthPrepass = false;
+GpuTimer* prepassTimer = nullptr;
+GpuTimer* shadeTimer[2] = {};
+
+// heap allocations (newhook.h) during the last drawn frame, 0 once warm
+unsigned long long g_FrameAllocations = 0;
+
+struct SceneFrame {
+    std::vector<glm::mat4> occluders;
+    std::vector<glm::mat4> occludees;
+    std::vector<OcclusionCuller::Box> boxes;    // world bounds of occludees
+    std::vector<char> visible;
+
+    // skinned models: grid cell (= character) of every instance
+    std::vector<int> occluderCells, occludeeCells;
+    std::vector<float> characterTimes;
+
+    // matrices of the drawn instances, in instance buffer order
+    std::vector<glm::mat4> drawn;
+};
+SceneFrame scene;
+
+// std140 layout of the FrameData block in phong.vert/phong.frag
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 lightPos;
+    glm::vec4 lightColor;   // w = ambient strength
+    glm::vec4 viewPos;
+};
 
 // glfw error
 void LogGLFWError(int error, const char* desc) {
@@ -101,10 +158,10 @@ void LogGLFWError(int error, const char* desc) {
 }
 
 // gl error checker
-void CheckGLError(const std::string& where) {
+void CheckGLError(const char* where) {
     GLenum e = glGetError();
     if (e != GL_NO_ERROR) {
-        std::string msg;
+        const char* msg;
 
         switch (e) {
             case GL_INVALID_ENUM: msg = "GL_INVALID_ENUM"; break;
@@ -112,10 +169,10 @@ void CheckGLError(const std::string& where) {
             case GL_INVALID_OPERATION: msg = "GL_INVALID_OPERATION"; break;
             case GL_OUT_OF_MEMORY: msg = "GL_OUT_OF_MEMORY"; break;
             case GL_INVALID_FRAMEBUFFER_OPERATION: msg = "GL_INVALID_FRAMEBUFFER_OPERATION"; break;
-            default: msg = "UNKNOWN_ERROR_" + std::to_string(e); break;
+            default: msg = FrameArena::get().format("UNKNOWN_ERROR_%u", (unsigned)e); break;
         }
 
-        LogError("OpenGL error at " + where + ": " + msg);
+        LogErrorf("OpenGL error at %s: %s", where, msg);
     }
 }
 
@@ -158,7 +215,8 @@ void InitScreenQuad() {
     glBindVertexArray(screenVAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, screenVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    MemoryRegistry::get().bufferData("screen quad", GL_ARRAY_BUFFER, screenVBO,
+                                     sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -167,16 +225,92 @@ void InitScreenQuad() {
     glEnableVertexAttribArray(1);
 }
 
+// world space AABB of the model's bounds under m
+OcclusionCuller::Box WorldBounds(const glm::mat4& m) {
+    OcclusionCuller::Box b = { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+
+    for (int c = 0; c < 8; c++) {
+        glm::vec3 p((c & 1) ? model->boundsMax.x : model->boundsMin.x,
+                    (c & 2) ? model->boundsMax.y : model->boundsMin.y,
+                    (c & 4) ? model->boundsMax.z : model->boundsMin.z);
+        glm::vec3 w = glm::vec3(m * glm::vec4(p, 1.0f));
+        b.min = glm::min(b.min, w);
+        b.max = glm::max(b.max, w);
+    }
+    return b;
+}
+
+// N x N grid on the xz plane, rows go away from the camera. every cell
+// gets one instance per node of the model's graph that draws the mesh
+void BuildScene(float rotationX) {
+    scene.occluders.clear();
+    scene.occludees.clear();
+    scene.boxes.clear();
+    scene.occluderCells.clear();
+    scene.occludeeCells.clear();
+
+    model->graph.update();
+    if (model->meshNodes.empty()) return;
+
+    glm::mat4 base = Model::getModelMatrix(rotationX);
+    glm::mat4 rest = Model::getModelMatrix(0.0f);
+    OcclusionCuller::Box b = { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+    for (int node : model->meshNodes) {
+        OcclusionCuller::Box nb = WorldBounds(rest * model->nodeMatrix(node));
+        b.min = glm::min(b.min, nb.min);
+        b.max = glm::max(b.max, nb.max);
+    }
+    glm::vec3 size = b.max - b.min;
+    float spacing = std::max(size.x, std::max(size.y, size.z)) * 1.25f;
+
+    for (int row = 0; row < g_Grid; row++) {
+        for (int col = 0; col < g_Grid; col++) {
+            glm::vec3 offset((col - (g_Grid - 1) * 0.5f) * spacing, 0.0f, -row * spacing);
+            glm::mat4 cell = glm::translate(glm::mat4(1.0f), offset) * base;
+
+            for (int node : model->meshNodes) {
+                glm::mat4 m = cell * model->nodeMatrix(node);
+
+                if (row == 0) {
+                    scene.occluders.push_back(m);
+                    scene.occluderCells.push_back(row * g_Grid + col);
+                } else {
+                    scene.occludees.push_back(m);
+                    scene.occludeeCells.push_back(row * g_Grid + col);
+                    scene.boxes.push_back(WorldBounds(m));
+                }
+            }
+        }
+    }
+}
+
 // cleanup
 void CleanupResources() {
     LogInfo("cleanup…");
 
-    delete phong;
-    delete skyboxShader;
-    delete screenShader;
+    shaders.destroy(phong);
+    shaders.destroy(skyboxShader);
+    shaders.destroy(screenShader);
+    shaders.destroy(depthShader);
+    shaders.destroy(occlusionShader);
+    shaders.destroy(phongSkinned);
+    shaders.destroy(depthSkinned);
+    delete occlusion;
     delete model;
     delete msaa;
-
+    delete stream;
+    delete gpuFrameTimer;
+    delete prepassTimer;
+    pacer.release();
+    delete shadeTimer[0];
+    delete shadeTimer[1];
+
+    MemoryRegistry& mem = MemoryRegistry::get();
+    mem.release(MemoryRegistry::BUFFER, skyVBO);
+    mem.release(MemoryRegistry::TEXTURE, cubemap);
+    mem.release(MemoryRegistry::BUFFER, screenVBO);
+
+    if (paletteTex) glDeleteTextures(1, &paletteTex);
     if (skyVAO) glDeleteVertexArrays(1, &skyVAO);
     if (skyVBO) glDeleteBuffers(1, &skyVBO);
     if (cubemap) glDeleteTextures(1, &cubemap);
@@ -186,8 +320,14 @@ void CleanupResources() {
     phong = nullptr;
     skyboxShader = nullptr;
     screenShader = nullptr;
+    depthShader = nullptr;
+    occlusionShader = nullptr;
+    occlusion = nullptr;
     model = nullptr;
     msaa = nullptr;
+    stream = nullptr;
+    gpuFrameTimer = nullptr;
+    prepassTimer = shadeTimer[0] = shadeTimer[1] = nullptr;
 
     skyVAO = skyVBO = cubemap = 0;
     screenVAO = screenVBO = 0;
@@ -220,7 +360,8 @@ void SetupSkybox() {
     glBindVertexArray(skyVAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, skyVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    MemoryRegistry::get().bufferData("skybox cube", GL_ARRAY_BUFFER, skyVBO,
+                                     sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), (void*)0);
@@ -230,6 +371,10 @@ void SetupSkybox() {
 
 // cubemap
 unsigned int LoadCubemap(const std::vector<std::string>& faces) {
+    PROFILE_SCOPE("LoadCubemap");
+    MemoryRegistry::LoadScope scope("cubemap");
+    MemoryRegistry& mem = MemoryRegistry::get();
+
     unsigned int tex;
     glGenTextures(1, &tex);
     glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
@@ -244,10 +389,12 @@ unsigned int LoadCubemap(const std::vector<std::string>& faces) {
             throw std::runtime_error("cubemap load failed");
         }
 
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0,
-                     GL_RGB, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        mem.cpuAlloc((size_t)w * h * 3);
+        mem.texImage2D("skybox cubemap", GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, tex, 0,
+                       GL_RGB, w, h, GL_RGB, GL_UNSIGNED_BYTE, data);
 
         stbi_image_free(data);
+        mem.cpuFree((size_t)w * h * 3);
     }
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -256,31 +403,96 @@ unsigned int LoadCubemap(const std::vector<std::string>& faces) {
     return tex;
 }
 
+// material block and samplers of a shader using phong.frag. every pool
+// sampler gets its own unit even when the model has fewer pools, unset
+// ones would sit on unit 0 next to the cubemap
+void SetupMaterialUniforms(Shader* s) {
+    s->setBlockBinding("Materials", MATERIAL_UBO_BINDING);
+    s->use();
+    s->setInt("environment", ENVIRONMENT_TEXTURE_UNIT);
+    for (int i = 0; i < TexturePools::MAX_POOLS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "pools[%d]", i);
+        s->setInt(name, MATERIAL_TEXTURE_UNIT + i);
+    }
+}
+
 // runtime MSAA
 void ApplyMSAA(int samples) {
     g_MSAA = samples;
     
     if (msaa) {
         msaa->recreate(samples);
+        redraw.invalidate();    // the resolved image went with the old FBO
         LogInfo("Recreated MSAA FBO with " + std::to_string(samples) + " samples");
     }
 }
 
+// nearer, and nearer or equal, in the current depth convention
+GLenum DepthLess() { return g_ReverseZ ? GL_GREATER : GL_LESS; }
+GLenum DepthLessEqual() { return g_ReverseZ ? GL_GEQUAL : GL_LEQUAL; }
+
+// runtime reverse-Z, swaps the depth format and the clip range
+void ApplyReverseZ(bool on) {
+    g_ReverseZ = on;
+
+#ifdef GL_ZERO_TO_ONE
+    if (g_ClipControl) glClipControl(GL_LOWER_LEFT, on ? GL_ZERO_TO_ONE : GL_NEGATIVE_ONE_TO_ONE);
+#endif
+
+    if (msaa) {
+        msaa->setDepthFormat(on ? GL_DEPTH32F_STENCIL8 : GL_DEPTH24_STENCIL8);
+        redraw.invalidate();
+    }
+}
+
+// the camera follows the depth convention the frame is drawn with
+void ApplyDepthConvention(Camera& cam) {
+    cam.reverseZ = g_ReverseZ;
+    cam.zeroToOne = g_ReverseZ && g_ClipControl;
+}
+
 // init resources
 void InitializeResources() {
+    PROFILE_SCOPE("InitializeResources");
+
     try {
-        phong = new Shader("shaders/phong.vert","shaders/phong.frag");
+        phong = shaders.create("shaders/phong.vert","shaders/phong.frag");
         if (!phong) throw std::runtime_error("phong = nullptr");
+        phong->setBlockBinding("FrameData", FRAME_UBO_BINDING);
 
-        skyboxShader = new Shader("shaders/skybox.vert","shaders/skybox.frag");
+        skyboxShader = shaders.create("shaders/skybox.vert","shaders/skybox.frag");
         if (!skyboxShader) throw std::runtime_error("skyboxShader = nullptr");
 
         // screen shader for MSAA resolve
-        screenShader = new Shader("shaders/screen.vert", "shaders/screen.frag");
+        screenShader = shaders.create("shaders/screen.vert", "shaders/screen.frag");
         if (!screenShader) throw std::runtime_error("screenShader = nullptr");
 
+        // occluder pre-pass and bounding box queries
+        depthShader = shaders.create("shaders/depth.vert", "shaders/depth.frag");
+        depthShader->setBlockBinding("FrameData", FRAME_UBO_BINDING);
+
+        occlusionShader = shaders.create("shaders/occlusion_box.vert", "shaders/depth.frag");
+        occlusionShader->setBlockBinding("FrameData", FRAME_UBO_BINDING);
+
+        occlusion = new OcclusionCuller();
+
         model = new Model("assets/glb/model_nvidia.glb");
         if (!model) throw std::runtime_error("model = nullptr");
+        SetupMaterialUniforms(phong);
+
+        if (model->skinned()) {
+            phongSkinned = shaders.create("shaders/phong_skinned.vert", "shaders/phong.frag");
+            phongSkinned->setBlockBinding("FrameData", FRAME_UBO_BINDING);
+            phongSkinned->use();
+            phongSkinned->setInt("bonePalette", PALETTE_TEXTURE_UNIT);
+            SetupMaterialUniforms(phongSkinned);
+
+            depthSkinned = shaders.create("shaders/depth_skinned.vert", "shaders/depth.frag");
+            depthSkinned->setBlockBinding("FrameData", FRAME_UBO_BINDING);
+            depthSkinned->use();
+            depthSkinned->setInt("bonePalette", PALETTE_TEXTURE_UNIT);
+        }
 
         std::vector<std::string> faces = {
             "assets/textures/skybox/right.png",
@@ -298,12 +510,43 @@ void InitializeResources() {
         InitScreenQuad();
 
         // create MSAA FBO
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-        msaa = new MSAA_FBO(width, height, g_MSAA);
+        msaa = new MSAA_FBO(g_Width, g_Height, g_MSAA);
+
+        // 1 MB per frame in flight, 4 with bone palettes. persistent writes
+        // bypass GL entirely, so a capture has to go through the orphaning path
+        size_t streamBytes = (model->skinned() ? 4 : 1) * 1024 * 1024;
+        stream = new StreamBuffer(streamBytes, !GLTraceCapture::get().active());
+
+        // the whole stream buffer as RGBA32F texels, palettes are addressed
+        // by texel offset so no per-frame rebinding is needed
+        if (model->skinned()) {
+            GLint maxTexels = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+            if ((size_t)maxTexels < stream->size / 16) {
+                LogWarning("texture buffer limit " + std::to_string(maxTexels) + " texels, palettes past it read zero");
+            }
+
+            glGenTextures(1, &paletteTex);
+            glBindTexture(GL_TEXTURE_BUFFER, paletteTex);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, stream->buffer);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        }
+
+        gpuFrameTimer = new GpuTimer();
+        prepassTimer = new GpuTimer();
+        shadeTimer[0] = new GpuTimer();
+        shadeTimer[1] = new GpuTimer();
 
         glEnable(GL_DEPTH_TEST);
 
+        // glClipControl isn't traced, a capture keeps the -1..1 range
+#ifdef GL_ZERO_TO_ONE
+        g_ClipControl = (GLAD_GL_VERSION_4_5 || GLAD_GL_ARB_clip_control) && !GLTraceCapture::get().active();
+#endif
+        if (g_ReverseZ) ApplyReverseZ(true);
+
+        LogInfo("GPU memory after init: " + std::to_string(MemoryRegistry::get().total() >> 10) + " KB");
+
     } catch(const std::exception& e) {
         LogError("resource init failed: " + std::string(e.what()));
         CleanupResources();
@@ -311,17 +554,351 @@ void InitializeResources() {
     }
 }
 
+// one frame of the scene into msaa, resolved into msaa->tex_resolved.
+// callers own stream->beginFrame/endFrame
+void RenderScene(const Camera& cam, float rotationX, float animTime) {
+    PROFILE_SCOPE("RenderScene");
+
+    glBindFramebuffer(GL_FRAMEBUFFER, msaa->fbo_msaa);
+    glViewport(0, 0, msaa->width, msaa->height);
+    glClearColor(0.1f,0.1f,0.2f,1.0f);
+    glClearDepth(g_ReverseZ ? 0.0 : 1.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDepthFunc(DepthLess());
+
+    glm::mat4 view = cam.getViewMatrix();
+    glm::mat4 proj = cam.getProjectionMatrix();
+
+    // per-frame uniforms
+    StreamBuffer::Allocation frameUbo = stream->alloc(sizeof(FrameUniforms));
+    if (frameUbo.ptr) {
+        FrameUniforms fu;
+        fu.view = view;
+        fu.projection = proj;
+        fu.lightPos = glm::vec4(0, 2, 2, 1);
+        fu.lightColor = glm::vec4(1, 1, 1, 0.4f);
+        fu.viewPos = glm::vec4(cam.position, 1);
+        memcpy(frameUbo.ptr, &fu, sizeof(fu));
+
+        glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_UBO_BINDING, stream->buffer,
+                          frameUbo.offset, sizeof(FrameUniforms));
+    }
+
+    // scene + what last frame's occlusion results let us skip
+    {
+        PROFILE_SCOPE("build scene");
+        model->animate(animTime);
+        BuildScene(rotationX);
+    }
+    {
+        PROFILE_SCOPE("cull");
+        occlusion->cull(scene.boxes, cam.position, scene.visible);
+    }
+
+    bool conditional = occlusion->mode == OcclusionCuller::CONDITIONAL;
+    size_t occluderCount = scene.occluders.size();
+    size_t drawCount = occluderCount;
+    for (char v : scene.visible) drawCount += v ? 1 : 0;
+
+    // instance transforms: occluders first, then the visible rest
+    StreamBuffer::Allocation inst = stream->alloc(drawCount * sizeof(glm::mat4), sizeof(glm::vec4));
+    if (inst.ptr) {
+        PROFILE_SCOPE("instances");
+        scene.drawn.assign(scene.occluders.begin(), scene.occluders.end());
+        for (size_t i = 0; i < scene.occludees.size(); i++) {
+            if (scene.visible[i]) scene.drawn.push_back(scene.occludees[i]);
+        }
+        memcpy(inst.ptr, scene.drawn.data(), drawCount * sizeof(glm::mat4));
+    }
+
+    // per instance, the meshlets facing the camera inside the frustum
+    bool meshlets = g_Meshlets && !model->meshlets.empty() && inst.ptr;
+    if (meshlets) {
+        PROFILE_SCOPE("meshlet cull");
+        glm::vec4 planes[6];
+        cam.getFrustumPlanes(planes);
+        model->meshlets.cull(scene.drawn.data(), (int)drawCount, planes, cam.position);
+    }
+
+    // skinned: one bone palette per grid cell, then per drawn instance the
+    // texel its palette starts at, in the same order as the transforms
+    bool skinned = model->skinned();
+    StreamBuffer::Allocation palettes, paletteIndex;
+    if (skinned) {
+        PROFILE_SCOPE("palettes");
+        int cells = g_Grid * g_Grid;
+        int joints = model->skeleton.jointCount();
+
+        // spread the characters over the clip so they don't move in lockstep
+        scene.characterTimes.resize(cells);
+        for (int i = 0; i < cells; i++) scene.characterTimes[i] = animTime + i * 0.37f;
+
+        palettes = stream->alloc((size_t)cells * joints * 12 * sizeof(float), 16);
+        paletteIndex = stream->alloc(drawCount * sizeof(int), sizeof(int));
+
+        if (palettes.ptr && paletteIndex.ptr) {
+            model->animateCrowd(scene.characterTimes.data(), cells, (float*)palettes.ptr);
+
+            int texel = (int)(palettes.offset / 16);
+            int* dst = (int*)paletteIndex.ptr;
+            for (int cell : scene.occluderCells) *dst++ = texel + cell * joints * 3;
+            for (size_t i = 0; i < scene.occludees.size(); i++) {
+                if (scene.visible[i]) *dst++ = texel + scene.occludeeCells[i] * joints * 3;
+            }
+        }
+    }
+    GLintptr pal = skinned ? paletteIndex.offset : -1;
+
+    // instances [first, first + count) of the instance buffer
+    auto drawInstances = [&](size_t first, size_t count) {
+        if (meshlets) {
+            model->drawMeshlets(stream->buffer, inst.offset, (int)first, (int)count);
+        } else {
+            model->drawInstanced(stream->buffer, inst.offset + (GLintptr)(first * sizeof(glm::mat4)), (int)count,
+                                 skinned ? pal + (GLintptr)(first * sizeof(int)) : -1);
+        }
+    };
+
+    stream->flush();
+
+    // model
+    Shader* shade = skinned ? phongSkinned : phong;
+    Shader* depth = skinned ? depthSkinned : depthShader;
+    if (skinned) {
+        glActiveTexture(GL_TEXTURE0 + PALETTE_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, paletteTex);
+    }
+
+    // every material of the model at once, no binds between them
+    model->bindMaterials(MATERIAL_UBO_BINDING, MATERIAL_TEXTURE_UNIT);
+    glActiveTexture(GL_TEXTURE0 + ENVIRONMENT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    glActiveTexture(GL_TEXTURE0);
+
+    // every drawn instance, or only the occludees; in conditional mode
+    // each occludee goes under its own query
+    auto drawScene = [&](bool occluders) {
+        size_t first = occluders ? 0 : occluderCount;
+
+        if (conditional) {
+            if (occluders) drawInstances(0, occluderCount);
+
+            for (size_t i = 0; i < scene.occludees.size(); i++) {
+                occlusion->beginConditional(i);
+                drawInstances(occluderCount + i, 1);
+                occlusion->endConditional();
+            }
+        } else {
+            drawInstances(first, drawCount - first);
+        }
+    };
+
+    unsigned long long frame = frameStats.frameIndex();
+
+    if (shade && model && frameUbo.ptr) {
+        try {
+            if (inst.ptr && (!skinned || (palettes.ptr && paletteIndex.ptr))) {
+                bool occluderPass = occlusion->mode != OcclusionCuller::OFF;
+
+                if (occluderPass) {
+                    // occluder depth pre-pass
+                    {
+                        PROFILE_SCOPE("depth pre-pass");
+                        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                        depth->use();
+                        drawInstances(0, occluderCount);
+                        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                    }
+                    {
+                        PROFILE_SCOPE("occlusion queries");
+                        occlusion->issueQueries(scene.boxes, cam.position, occlusionShader->ID);
+                        occlusion->captureDepth(*msaa, proj * view, cam.reverseZ, cam.zeroToOne);
+                    }
+                }
+
+                // the rest of the depth, the occluders are already in
+                if (g_DepthPrepass) {
+                    PROFILE_SCOPE("full pre-pass");
+                    prepassTimer->begin(frame);
+                    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                    depth->use();
+                    drawScene(!occluderPass);
+                    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                    prepassTimer->end();
+
+                    // depth is final, shade only the samples that won
+                    glDepthFunc(GL_EQUAL);
+                    glDepthMask(GL_FALSE);
+                } else if (occluderPass) {
+                    // occluders shade on top of their own depth
+                    glDepthFunc(DepthLessEqual());
+                }
+
+                PROFILE_SCOPE("shade");
+                GpuTimer* shadeTime = shadeTimer[g_DepthPrepass ? 1 : 0];
+                shadeTime->begin(frame);
+                shade->use();
+
+                drawScene(true);
+
+                shadeTime->end();
+                glDepthMask(GL_TRUE);
+                glDepthFunc(DepthLess());
+            }
+        } catch (...) {
+            LogError("model render fail");
+        }
+    }
+
+    // skybox
+    try {
+        PROFILE_SCOPE("skybox");
+        glDepthFunc(DepthLessEqual());
+        skyboxShader->use();
+
+        glm::mat4 viewNoTrans = glm::mat4(glm::mat3(view));
+        skyboxShader->setMat4("view", viewNoTrans);
+        skyboxShader->setMat4("projection", proj);
+        skyboxShader->setFloat("farDepth", cam.farClipDepth());
+
+        glBindVertexArray(skyVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+
+        glDepthFunc(DepthLess());
+    } catch (...) {
+        LogError("skybox fail");
+    }
+
+    {
+        PROFILE_SCOPE("resolve");
+        msaa->resolve();
+    }
+}
+
+// what RenderScene's output depends on, see redraw.h
+SceneKey MakeSceneKey(const Camera& cam, float rotationX, float animTime) {
+    SceneKey k;
+    k.view = cam.getViewMatrix();
+    k.projection = cam.getProjectionMatrix();
+    k.rotationX = rotationX;
+    k.animTime = model->animated() ? animTime : 0.0f;
+    k.clip = model->clip;
+    k.grid = g_Grid;
+    k.msaa = g_MSAA;
+    k.occlusion = (int)occlusion->mode;
+    k.meshlets = g_Meshlets ? 1 : 0;
+    k.width = msaa->width;
+    k.height = msaa->height;
+    return k;
+}
+
+// largest t_grid whose per-frame data fits a stream region. skinned
+// cells each need a bone palette next to their transform and palette index
+int MaxGrid() {
+    const int LIMIT = 64;
+    if (!model->skinned()) return LIMIT;
+
+    size_t perCell = (size_t)model->skeleton.jointCount() * 12 * sizeof(float) + sizeof(glm::mat4) + sizeof(int);
+    size_t reserved = 64 * 1024;    // frame uniforms and alignment padding
+    size_t room = stream->regionSize > reserved ? stream->regionSize - reserved : 0;
+
+    int grid = 1;
+    while (grid < LIMIT && (size_t)(grid + 1) * (grid + 1) * perCell <= room) grid++;
+    return grid;
+}
+
+// on demand keeps vsync on, see FramePacer::applySwapInterval
+void ApplyOnDemand(bool on) {
+    redraw.onDemand = on;
+    redraw.invalidate();
+    if (window) pacer.applySwapInterval(on);
+}
+
+// --render-seq: headless turntable, one full turn over `frames` frames
+struct SequenceOptions {
+    int frames = 0;
+    std::string outDir = "render_seq";
+    ImageFormat format = ImageFormat::PNG;
+    int threads = 0;    // 0 = hardware threads - 1
+};
+
+int RunRenderSequence(const SequenceOptions& opt) {
+    std::error_code ec;
+    std::filesystem::create_directories(opt.outDir, ec);
+    if (ec) {
+        LogError("cannot create " + opt.outDir + ": " + ec.message());
+        return 1;
+    }
+
+    int threads = opt.threads > 0 ? opt.threads : std::max(1, (int)std::thread::hardware_concurrency() - 1);
+
+    Camera cam((float)g_Width, (float)g_Height);
+    PboReadback readback(g_Width, g_Height);
+    ImageWriterPool writer(opt.outDir, opt.format, g_Width, g_Height, threads, threads * 2);
+
+    auto sink = [&](unsigned long long frame, const unsigned char* rgba) {
+        writer.submit(frame, rgba);
+    };
+
+    LogInfo("render-seq: " + std::to_string(opt.frames) + " frames " + std::to_string(g_Width) + "x" +
+            std::to_string(g_Height) + " -> " + opt.outDir + " (" + ImageFormatExt(opt.format) + ", " +
+            std::to_string(threads) + " encoder threads)");
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    for (int f = 0; f < opt.frames; f++) {
+        FrameArena::get().reset();
+
+        // fixed step instead of wall time so every run gives the same frames
+        float rotationX = f * (2.0f * 3.14159265f / opt.frames);
+
+        stream->beginFrame();
+        ApplyDepthConvention(cam);
+        RenderScene(cam, rotationX, f / 30.0f);
+        readback.read(msaa->fbo_resolve, (unsigned long long)f, sink);
+        stream->endFrame();
+        occlusion->endFrame();
+        Profiler::get().endFrame();
+
+        glFlush();
+        readback.collect(false, sink);
+    }
+
+    readback.collect(true, sink);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    writer.finish();
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    double renderSeconds = std::chrono::duration<double>(t1 - t0).count();
+    double totalSeconds = std::chrono::duration<double>(t2 - t0).count();
+
+    char line[256];
+    snprintf(line, sizeof(line),
+             "render-seq: %llu written, %llu failed in %.2f s = %.1f fps end-to-end "
+             "(render+readback %.1f fps, readback stalls %llu, encoder backpressure %.2f s)",
+             writer.written, writer.failed, totalSeconds, opt.frames / totalSeconds,
+             opt.frames / renderSeconds, readback.stalls, writer.submitWaitSeconds);
+    LogInfo(line);
+
+    CheckGLError("RenderSequence");
+    return writer.failed ? 1 : 0;
+}
+
 // command handler
-void ExecuteCommand(const std::string& cmd) {
-    LogInfo("cmd: " + cmd);
+void ExecuteCommand(const char* cmd) {
+    PROFILE_SCOPE("ExecuteCommand");
+    LogInfof("cmd: %s", cmd);
+    frameStats.note(FrameArena::get().format("cmd %s", cmd));
 
-    std::stringstream ss(cmd);
-    std::string name;
-    ss >> name;
+    // tokens live in the frame arena and are nul-terminated there
+    ConsoleCommand c = ConsoleCommand::parse(cmd);
+    std::string_view name = c.name;
 
     if (name == "t_msaa") {
-        int x;
-        ss >> x;
+        int x = c.intArg(0, -1);
 
         if (x==0 || x==2 || x==4 || x==8) {
             ApplyMSAA(x);
@@ -337,8 +914,192 @@ void ExecuteCommand(const std::string& cmd) {
         return;
     }
 
+    if (name == "occl") {
+        std::string_view m = c.arg(0);
+        int mode = -1;
+        for (int i = 0; i < OcclusionCuller::MODE_COUNT; i++) {
+            if (m == OcclusionCuller::modeName(i)) mode = i;
+        }
+
+        if (mode < 0) {
+            LogWarning("usage: occl off|query|cond|hiz");
+        } else {
+            occlusion->setMode((OcclusionCuller::Mode)mode);
+            LogInfof("occlusion culling: %s", m.data());
+        }
+        return;
+    }
+
+    if (name == "t_grid") {
+        int n = c.intArg(0, -1);
+
+        if (n >= 1 && n <= 64) {
+            int limit = MaxGrid();
+            if (n > limit) {
+                LogWarningf("grid %dx%d: the bone palettes don't fit the stream buffer, clamped to %dx%d",
+                            n, n, limit, limit);
+                n = limit;
+            }
+            g_Grid = n;
+            LogInfof("grid %dx%d", n, n);
+        } else {
+            LogWarning("invalid grid size (1..64)");
+        }
+        return;
+    }
+
+    if (name == "anim") {
+        int i = c.intArg(0, -1);
+
+        if (i >= 0 && i < (int)model->clips.size()) {
+            model->clip = i;
+            LogInfof("animation %d: %s", i, model->clips[i].name.c_str());
+        } else {
+            LogWarningf("usage: anim N (0..%d)", (int)model->clips.size() - 1);
+        }
+        return;
+    }
+
+    if (name == "stats") {
+        std::string_view sub = c.arg(0);
+
+        if (sub == "dump") {
+            const char* path = c.arg(1).empty() ? "frame_stats.csv" : c.arg(1).data();
+            if (frameStats.dumpCsv(path)) LogInfof("frame stats written to %s", path);
+            else LogErrorf("cannot write %s", path);
+        } else if (sub == "reset") {
+            frameStats.reset();
+        } else if (sub == "stutter" && c.argCount > 1 && atof(c.arg(1).data()) > 1.0) {
+            frameStats.stutterFactor = (float)atof(c.arg(1).data());
+        } else {
+            LogWarning("usage: stats dump [file] | stats reset | stats stutter X");
+        }
+        return;
+    }
+
+    if (name == "meshlets") {
+        std::string_view m = c.arg(0);
+
+        if (m == "on" || m == "off") {
+            g_Meshlets = m == "on";
+            LogInfof("meshlet culling: %s", m.data());
+        } else {
+            LogWarning("usage: meshlets on|off");
+        }
+        return;
+    }
+
+    if (name == "ondemand") {
+        std::string_view m = c.arg(0);
+
+        if (m == "on" || m == "off") {
+            ApplyOnDemand(m == "on");
+            LogInfof("render on demand: %s", m.data());
+        } else {
+            LogWarning("usage: ondemand on|off");
+        }
+        return;
+    }
+
+    if (name == "inflight") {
+        int n = c.intArg(0, 0);
+
+        if (n >= 1 && n <= FramePacer::MAX_IN_FLIGHT) {
+            pacer.maxFramesInFlight = n;
+            LogInfof("max frames in flight: %d", n);
+        } else {
+            LogWarningf("usage: inflight 1..%d", FramePacer::MAX_IN_FLIGHT);
+        }
+        return;
+    }
+
+    if (name == "fpslimit") {
+        int n = c.intArg(0, -1);
+
+        if (n >= 0) {
+            pacer.limiter.fps = n;
+            if (n) LogInfof("frame-rate limit: %d fps", n);
+            else LogInfo("frame-rate limit: off");
+        } else {
+            LogWarning("usage: fpslimit N (0 = off)");
+        }
+        return;
+    }
+
+    if (name == "vsync") {
+        std::string_view m = c.arg(0);
+
+        if (m == "off" || m == "on" || m == "adaptive") {
+            pacer.vsync = m == "off" ? FramePacer::VSYNC_OFF : m == "on" ? FramePacer::VSYNC_ON : FramePacer::VSYNC_ADAPTIVE;
+            pacer.applySwapInterval(redraw.onDemand);
+            LogInfof("vsync: %s (swap interval %d)", m.data(), pacer.swapInterval);
+        } else {
+            LogWarning("usage: vsync off|on|adaptive");
+        }
+        return;
+    }
+
+    if (name == "pause") {
+        g_Paused = !g_Paused;
+        LogInfo(g_Paused ? "paused" : "resumed");
+        return;
+    }
+
+    if (name == "prepass") {
+        std::string_view m = c.arg(0);
+
+        // the depth shader has no alpha test, cut-outs would come out
+        // as holes to the clear color under GL_EQUAL
+        bool masked = false;
+        for (const MaterialData& d : model->materials) masked |= d.alphaCutoff > 0.0f;
+
+        if (m == "on" && masked) {
+            LogWarning("depth pre-pass: the model has alpha-masked materials, left off");
+        } else if (m == "on" || m == "off") {
+            g_DepthPrepass = m == "on";
+            LogInfof("depth pre-pass: %s", m.data());
+        } else {
+            LogWarning("usage: prepass on|off");
+        }
+        return;
+    }
+
+    if (name == "profile") {
+        std::string_view sub = c.arg(0);
+
+        if (sub == "startup") {
+            const char* path = c.arg(1).empty() ? "profile_startup.json" : c.arg(1).data();
+            if (Profiler::get().writeStartup(path)) LogInfof("startup profile written to %s", path);
+            else LogErrorf("cannot write %s", path);
+        } else if (c.intArg(0, 0) > 0) {
+            const char* path = c.arg(1).empty() ? "profile.json" : c.arg(1).data();
+            Profiler::get().capture(c.intArg(0, 0), path);
+            LogInfof("profiling %d frame(s) to %s", c.intArg(0, 0), path);
+        } else {
+            LogWarning("usage: profile N [file] | profile startup [file]");
+        }
+        return;
+    }
+
+    if (name == "reversez") {
+        std::string_view m = c.arg(0);
+
+        if (m == "on" || m == "off") {
+            ApplyReverseZ(m == "on");
+            LogInfof("reverse-Z: %s (%s)", m.data(), g_ClipControl ? "clip control" : "no clip control");
+        } else {
+            LogWarning("usage: reversez on|off");
+        }
+        return;
+    }
+
+    if (name == "mem") {
+        std::cout << MemoryRegistry::get().report((size_t)std::max(1, c.intArg(0, 10)));
+        return;
+    }
+
     if (name == "help") {
-        std::cout << "commands: help, info, t_msaa X\n";
+        std::cout << ConsoleHelp() << "\n";
         return;
     }
 
@@ -409,12 +1170,41 @@ bool InitializeOpenGL() {
     return true;
 }
 
+// any input redraws the overlay in on-demand mode. installed before
+// imgui, whose glfw backend chains to these
+void OnInput() {
+    redraw.wake();
+    pacer.input();
+}
+
+void WakeOnInput(GLFWwindow* w) {
+    glfwSetKeyCallback(w, [](GLFWwindow*, int, int, int, int) { OnInput(); });
+    glfwSetCharCallback(w, [](GLFWwindow*, unsigned int) { OnInput(); });
+    glfwSetMouseButtonCallback(w, [](GLFWwindow*, int, int, int) { OnInput(); });
+    glfwSetCursorPosCallback(w, [](GLFWwindow*, double, double) { OnInput(); });
+    glfwSetScrollCallback(w, [](GLFWwindow*, double, double) { OnInput(); });
+    glfwSetWindowFocusCallback(w, [](GLFWwindow*, int) { redraw.wake(); });
+    glfwSetWindowRefreshCallback(w, [](GLFWwindow*) { redraw.wake(); });
+}
+
 // imgui
+// imgui's heap goes through the allocation counter as well
+void* ImGuiCountedAlloc(size_t size, void*) {
+    AllocationCounter::add(size);
+    return malloc(size);
+}
+
+void ImGuiCountedFree(void* p, void*) {
+    free(p);
+}
+
 bool InitializeImGui() {
     IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(ImGuiCountedAlloc, ImGuiCountedFree);
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
 
+    WakeOnInput(window);
     if (!ImGui_ImplGlfw_InitForOpenGL(window,true)) return false;
     if (!ImGui_ImplOpenGL3_Init("#version 330")) return false;
 
@@ -422,125 +1212,283 @@ bool InitializeImGui() {
 }
 
 // main
-int main() {
+int main(int argc, char** argv) {
     InitializeLogFile();
     LogSystemInfo();
 
+    // --capture <file> [frames]: record resource setup + N frames of GL calls
+    std::string capturePath;
+    int captureFrames = 1;
+
+    // --render-seq N [--out dir] [--format png|exr|raw] [--size WxH] [--threads N]
+    SequenceOptions seq;
+
+    // --ondemand: start with render on demand (console: ondemand on|off)
+    bool onDemand = false;
+
+    // --vsync off|on|adaptive, --fpslimit N, --inflight N: see pacing.h
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') captureFrames = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--render-seq" && i + 1 < argc) {
+            seq.frames = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            seq.outDir = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc) {
+            if (!ParseImageFormat(argv[++i], seq.format)) LogWarning(std::string("unknown format: ") + argv[i]);
+        } else if (arg == "--size" && i + 1 < argc) {
+            int w = 0, h = 0;
+            if (sscanf(argv[++i], "%dx%d", &w, &h) == 2 && w > 0 && h > 0) {
+                g_Width = w;
+                g_Height = h;
+            } else {
+                LogWarning(std::string("bad --size: ") + argv[i]);
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            seq.threads = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--ondemand") {
+            onDemand = true;
+        } else if (arg == "--vsync" && i + 1 < argc) {
+            std::string m = argv[++i];
+            if (m == "off") pacer.vsync = FramePacer::VSYNC_OFF;
+            else if (m == "on") pacer.vsync = FramePacer::VSYNC_ON;
+            else if (m == "adaptive") pacer.vsync = FramePacer::VSYNC_ADAPTIVE;
+            else LogWarning("bad --vsync: " + m);
+        } else if (arg == "--fpslimit" && i + 1 < argc) {
+            pacer.limiter.fps = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--inflight" && i + 1 < argc) {
+            pacer.maxFramesInFlight = std::min(std::max(atoi(argv[++i]), 1), (int)FramePacer::MAX_IN_FLIGHT);
+        } else {
+            LogWarning("unknown argument: " + arg);
+        }
+    }
+
+    // headless: no window, no imgui
+    if (seq.frames > 0) {
+        int result = 1;
+        OffscreenContext offscreen;
+
+        try {
+            if (!offscreen.create()) throw std::runtime_error("offscreen context fail");
+            LogInfo(std::string("OpenGL: ") + (const char*)glGetString(GL_VERSION));
+
+            InitializeResources();
+            Profiler::get().keepStartup();
+            result = RunRenderSequence(seq);
+        } catch (const std::exception& e) {
+            LogError("fatal: " + std::string(e.what()));
+        }
+
+        CleanupResources();
+        offscreen.destroy();
+
+        if (logFile.is_open()) {
+            logFile << "=== log ended at " << GetCurrentTimeStamp() << " ===" << std::endl;
+            logFile.close();
+        }
+        return result;
+    }
+
     try {
         if (!InitializeGLFW()) throw std::runtime_error("glfw init fail");
         if (!CreateInitialWindow()) throw std::runtime_error("window fail");
         if (!InitializeOpenGL()) throw std::runtime_error("opengl fail");
         if (!InitializeImGui()) throw std::runtime_error("imgui fail");
 
+        glfwGetFramebufferSize(window, &g_Width, &g_Height);
+
+        if (!capturePath.empty()) {
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+            GLTraceCapture::get().start(capturePath, captureFrames, width, height);
+            LogInfo("capturing " + std::to_string(captureFrames) + " frame(s) to " + capturePath);
+        }
+
         InitializeResources();
+        GLTraceCapture::get().setupDone();
+        Profiler::get().keepStartup();
+        if (onDemand) ApplyOnDemand(true);
+        else pacer.applySwapInterval(false);
 
-        Camera cam(1280,720);
+        Camera cam((float)g_Width, (float)g_Height);
         float rotationX = 0;
+        float animTime = 0;
 
         // toggle fix
         bool f1Held = false;
 
+        frameStats.restartClock();
+
         while (!glfwWindowShouldClose(window)) {
+            FrameArena::get().reset();
+            unsigned long long allocationsBefore = AllocationCounter::now();
+
+            // nothing to draw: sleep until input, or the timeout so the
+            // console numbers don't freeze
+            if (redraw.idle()) {
+                glfwWaitEventsTimeout(RedrawTracker::IDLE_TIMEOUT);
+                frameStats.skipWait();
+                if (showConsole) redraw.refresh();
+            } else {
+                pacer.limit();
+                glfwPollEvents();
+            }
+
             float t = glfwGetTime();
             float dt = t - lastTime;
             lastTime = t;
 
-            glfwPollEvents();
-
             // toggle console (fixed)
             if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS) {
                 if (!f1Held) {
                     showConsole = !showConsole;
                     f1Held = true;
+                    redraw.wake();
                 }
             } else {
                 f1Held = false;
             }
 
-            glBindFramebuffer(GL_FRAMEBUFFER, msaa->fbo_msaa);
-            glClearColor(0.1f,0.1f,0.2f,1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
             // animate model
-            rotationX += dt * 0.5f;
-
-            glm::mat4 view = cam.getViewMatrix();
-            glm::mat4 proj = cam.getProjectionMatrix();
-
-            // model
-            if (phong && model) {
-                try {
-                    phong->use();
-                    phong->setMat4("view", view);
-                    phong->setMat4("projection", proj);
-                    phong->setMat4("model", model->getModelMatrix(rotationX));
-                    phong->setVec3("lightPos", glm::vec3(0,2,2));
-                    phong->setVec3("lightColor", glm::vec3(1,1,1));
-                    phong->setFloat("ambientStrength", 0.4f);
-                    phong->setVec3("viewPos", cam.position);
-                    model->draw();
-                } catch (...) {
-                    LogError("model render fail");
-                }
+            if (!g_Paused) {
+                rotationX += dt * 0.5f;
+                animTime += dt;
             }
 
-            // skybox
-            try {
-                glDepthFunc(GL_LEQUAL);
-                skyboxShader->use();
+            // unchanged scene: the last resolved image plus a fresh overlay,
+            // or nothing at all
+            ApplyDepthConvention(cam);
+            bool drawScene = redraw.needsScene(MakeSceneKey(cam, rotationX, animTime));
+            if (!drawScene && !redraw.needsOverlay()) continue;
 
-                glm::mat4 viewNoTrans = glm::mat4(glm::mat3(view));
-                skyboxShader->setMat4("view", viewNoTrans);
-                skyboxShader->setMat4("projection", proj);
+            pacer.beginFrame();
+            stream->beginFrame();
+            gpuFrameTimer->begin(frameStats.frameIndex());
 
-                glBindVertexArray(skyVAO);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+            if (drawScene) RenderScene(cam, rotationX, animTime);
 
-                glDrawArrays(GL_TRIANGLES, 0, 36);
+            {
+                PROFILE_SCOPE("composite");
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-                glDepthFunc(GL_LESS);
-            } catch (...) {
-                LogError("skybox fail");
+                screenShader->use();
+                glBindVertexArray(screenVAO);
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, msaa->tex_resolved);
+                glDrawArrays(GL_TRIANGLES, 0, 6);
             }
 
-            msaa->resolve();
-
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-            screenShader->use();
-            glBindVertexArray(screenVAO);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, msaa->tex_resolved);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+            // imgui, kept out of GL traces
+            {
+                PROFILE_SCOPE("imgui");
+                GLTraceCapture::get().pause();
+                ImGui_ImplOpenGL3_NewFrame();
+                ImGui_ImplGlfw_NewFrame();
+                ImGui::NewFrame();
+
+                if (showConsole) {
+                    ImGui::Begin("Console", NULL, ImGuiWindowFlags_AlwaysAutoResize);
+                    static char buf[256];
+
+                    if (ImGui::InputText("cmd", buf, 256, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                        ExecuteCommand(buf);
+                        buf[0] = 0;
+                    }
+
+                    ImGui::Text("FPS = %.1f (median)", frameStats.p50 > 0.0f ? 1000.0f / frameStats.p50 : 0.0f);
+                    ImGui::Text("FrameTime = p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms, GPU p50 %.2f ms",
+                                frameStats.p50, frameStats.p95, frameStats.p99, frameStats.maxMs, frameStats.gpuP50);
+                    ImGui::Text("MSAA = %dx", g_MSAA);
+                    ImGui::Text("Pacing = vsync %s (interval %d), limit %s, %d frame(s) in flight, "
+                                "waited %.2f ms limiter / %.2f ms GPU",
+                                FramePacer::vsyncName(pacer.vsync), pacer.swapInterval,
+                                pacer.limiter.fps > 0 ? FrameArena::get().format("%d fps", pacer.limiter.fps) : "off",
+                                pacer.maxFramesInFlight, pacer.limiter.waitMs, pacer.fenceWaitMs);
+                    ImGui::Text("Input latency = to swap p50 %.1f p95 %.1f ms, to GPU done p50 %.1f p95 %.1f ms",
+                                pacer.swapLatencyP50, pacer.swapLatencyP95, pacer.gpuLatencyP50, pacer.gpuLatencyP95);
+                    ImGui::Text("Depth = %s, %s clip range, pre-pass %s: pre-pass %.2f + shade %.2f ms "
+                                "(shade without pre-pass %.2f ms)",
+                                g_ReverseZ ? "reverse-Z D32F" : "D24S8",
+                                g_ReverseZ && g_ClipControl ? "0..1" : "-1..1", g_DepthPrepass ? "on" : "off",
+                                g_DepthPrepass ? prepassTimer->lastMs : 0.0, shadeTimer[g_DepthPrepass ? 1 : 0]->lastMs,
+                                shadeTimer[0]->lastMs);
+                    ImGui::Text("Allocations = %llu last frame, %llu since start, frame arena %.1f/%.1f KB",
+                                g_FrameAllocations, AllocationCounter::now(),
+                                FrameArena::get().bytesPeak() / 1024.0f, FrameArena::get().bytesCapacity() / 1024.0f);
+                    ImGui::Text("Redraw = %s%s, %llu scene / %llu overlay-only frames",
+                                redraw.onDemand ? "on demand" : "every frame", g_Paused ? ", paused" : "",
+                                redraw.sceneFrames, redraw.overlayFrames);
+                    ImGui::Text("Stream = %.1f KB/frame, stalls %u (total %llu), orphans %u, %s",
+                                stream->bytesLastFrame / 1024.0f, stream->stallsLastFrame,
+                                stream->totalStalls, stream->orphansLastFrame, stream->modeName());
+                    ImGui::Text("Occlusion = %s, %d/%d culled, %.1fk tris saved, cpu %.2f ms (%s)",
+                                OcclusionCuller::modeName(occlusion->mode), occlusion->culled, occlusion->tested,
+                                occlusion->culled * (model->indexCount / 3) / 1000.0f, occlusion->cpuMs,
+                                occlusion->queryName());
+
+                    if (model->meshlets.empty()) {
+                        ImGui::Text("Meshlets = none (skinned)");
+                    } else {
+                        const MeshletSet& ms = model->meshlets;
+                        ImGui::Text("Meshlets = %s, %d per instance, %.1f%% of triangles culled "
+                                    "(%.1f%% back-facing, %.1f%% outside), cpu %.2f ms",
+                                    g_Meshlets ? "on" : "off", (int)ms.meshlets.size(),
+                                    g_Meshlets ? ms.culledFraction() * 100.0f : 0.0f,
+                                    g_Meshlets && ms.trianglesTested ? 100.0f * ms.backfaceCulled / ms.trianglesTested : 0.0f,
+                                    g_Meshlets && ms.trianglesTested ? 100.0f * ms.frustumCulled / ms.trianglesTested : 0.0f,
+                                    g_Meshlets ? ms.cpuMs : 0.0f);
+                    }
+
+                    if (model->animated()) {
+                        ImGui::Text("Animation = '%s' (%d/%d), %d characters x %d joints, cpu %.2f ms",
+                                    model->clips[model->clip].name.c_str(), model->clip + 1, (int)model->clips.size(),
+                                    model->crowd.characters, model->skeleton.jointCount(), model->crowd.cpuMs);
+                    }
+
+                    if (ImGui::CollapsingHeader("Frame stats")) frameStats.drawImGui();
+                    if (ImGui::CollapsingHeader("Profiler")) Profiler::get().drawImGui();
+
+                    ImGui::End();
+                }
 
-            // imgui
-            ImGui_ImplOpenGL3_NewFrame();
-            ImGui_ImplGlfw_NewFrame();
-            ImGui::NewFrame();
+                ImGui::Render();
+                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+                GLTraceCapture::get().resume();
+            }
 
-            if (showConsole) {
-                ImGui::Begin("Console", NULL, ImGuiWindowFlags_AlwaysAutoResize);
-                static char buf[256];
+            stream->endFrame();
+            if (drawScene) occlusion->endFrame();
 
-                if (ImGui::InputText("cmd", buf, 256, ImGuiInputTextFlags_EnterReturnsTrue)) {
-                    ExecuteCommand(buf);
-                    buf[0] = 0;
-                }
+            gpuFrameTimer->end();
+            GLTraceCapture::get().frame();
 
-                ImGui::Text("FPS = %.1f", 1.0f / dt);
-                ImGui::Text("FrameTime = %.3f ms", dt * 1000.0f);
-                ImGui::Text("MSAA = %dx", g_MSAA);
-
-                ImGui::End();
+            {
+                PROFILE_SCOPE("swap");
+                glfwSwapBuffers(window);
+                pacer.presented();
             }
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            if (Profiler::get().endFrame()) {
+                std::string path;
+                if (Profiler::get().captureResult(path)) LogInfof("profile written to %s", path.c_str());
+                else LogErrorf("cannot write %s", path.c_str());
+            }
 
-            glfwSwapBuffers(window);
+            frameStats.tick();
+            double gpuMs;
+            unsigned long long gpuFrame;
+            while (gpuFrameTimer->poll(gpuMs, gpuFrame)) frameStats.setGpu(gpuFrame, (float)gpuMs);
+            prepassTimer->pollLatest();
+            shadeTimer[0]->pollLatest();
+            shadeTimer[1]->pollLatest();
             CheckGLError("MainLoop");
+
+            g_FrameAllocations = AllocationCounter::now() - allocationsBefore;
         }
 
     } catch(const std::exception& e) {
@@ -548,6 +1496,7 @@ int main() {
     }
 
     // shutdown
+    GLTraceCapture::get().finish();
     CleanupResources();
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -0,0 +1,192 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <tiny_gltf.h>
+#include <stb/stb_image.h>
+#include <vector>
+#include <string>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+
+#include "profiler.h"
+
+// glTF metallic-roughness materials of the loaded mesh and the images
+// they use, decoded on the CPU in parallel. the GL side (texture array
+// pools, material buffer) is set up by Model::upload.
+
+enum TextureWrap { WRAP_REPEAT = 0, WRAP_CLAMP = 1, WRAP_MIRROR = 2 };
+
+struct MaterialData {
+    std::string name;
+    glm::vec4 baseColor = glm::vec4(1.0f);
+    float metallic = 1.0f;
+    float roughness = 1.0f;
+    float normalScale = 1.0f;
+    float alphaCutoff = 0.0f;       // > 0 for alphaMode MASK
+    bool doubleSided = false;
+
+    // index into MaterialSet::textures, -1 = none
+    int baseColorTexture = -1, normalTexture = -1, metalRoughTexture = -1;
+    int wrap = 0;                   // 2 bits S, 2 bits T per texture, in the order above
+};
+
+// an image as one usage needs it: base color is sRGB, normal and
+// metal-rough maps are linear data
+struct DecodedTexture {
+    int image = -1;
+    bool srgb = false;
+    int width = 0, height = 0;      // 0 until decoded, stays 0 if decoding failed
+    std::vector<unsigned char> rgba;
+};
+
+// std140 layout of one entry of the Materials block in phong.frag
+struct MaterialUniforms {
+    glm::vec4 baseColor;
+    glm::vec4 factors;              // metallic, roughness, normal scale, alpha cutoff
+    glm::ivec4 baseAndNormal;       // pool + layer of the base color and normal map, -1 = none
+    glm::ivec4 metalRough;          // pool, layer, wrap bits, double sided
+};
+
+class MaterialSet {
+public:
+    // entries of the Materials block, see phong.frag
+    static const int MAX_MATERIALS = 256;
+
+    std::vector<MaterialData> materials;
+    std::vector<DecodedTexture> textures;
+
+    // local index of glTF material (-1 = the spec's default material),
+    // added on first use. past MAX_MATERIALS everything shares the last one
+    int add(const tinygltf::Model& m, int material) {
+        auto found = local.find(material);
+        if (found != local.end()) return found->second;
+        if ((int)materials.size() == MAX_MATERIALS) return MAX_MATERIALS - 1;
+
+        MaterialData d;
+        if (material >= 0 && material < (int)m.materials.size()) {
+            const tinygltf::Material& src = m.materials[material];
+            const tinygltf::PbrMetallicRoughness& pbr = src.pbrMetallicRoughness;
+
+            d.name = src.name;
+            if (pbr.baseColorFactor.size() == 4) {
+                d.baseColor = glm::vec4((float)pbr.baseColorFactor[0], (float)pbr.baseColorFactor[1],
+                                        (float)pbr.baseColorFactor[2], (float)pbr.baseColorFactor[3]);
+            }
+            d.metallic = (float)pbr.metallicFactor;
+            d.roughness = (float)pbr.roughnessFactor;
+            d.normalScale = (float)src.normalTexture.scale;
+            d.alphaCutoff = src.alphaMode == "MASK" ? std::max((float)src.alphaCutoff, 1e-4f) : 0.0f;
+            d.doubleSided = src.doubleSided;
+
+            d.baseColorTexture = texture(m, pbr.baseColorTexture.index, true, d.wrap, 0);
+            d.normalTexture = texture(m, src.normalTexture.index, false, d.wrap, 4);
+            d.metalRoughTexture = texture(m, pbr.metallicRoughnessTexture.index, false, d.wrap, 8);
+        }
+
+        local[material] = (int)materials.size();
+        materials.push_back(d);
+        return (int)materials.size() - 1;
+    }
+
+    // decode every texture added so far, threads = 0 uses every core.
+    // images come either still encoded (KeepEncodedImage) or already
+    // decoded by tinygltf's default loader
+    void decodeImages(const tinygltf::Model& m, int threads = 0) {
+        if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, (int)textures.size());
+
+        std::atomic<int> next(0);
+        auto work = [&] {
+            for (int i = next++; i < (int)textures.size(); i = next++) {
+                PROFILE_SCOPE("decode image");
+                decode(m.images[textures[i].image], textures[i]);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) pool.emplace_back(work);
+        work();
+        for (std::thread& t : pool) t.join();
+    }
+
+    // tinygltf image callback that only keeps the encoded file, so the
+    // loader doesn't decode one image after the other. width stays -1
+    static bool KeepEncodedImage(tinygltf::Image* image, const int, std::string*, std::string*,
+                                 int, int, const unsigned char* bytes, int size, void*) {
+        image->image.assign(bytes, bytes + size);
+        image->width = image->height = -1;
+        return true;
+    }
+
+private:
+    std::map<int, int> local;                       // glTF material -> index
+    std::map<std::pair<int, bool>, int> byImage;    // (glTF image, srgb) -> texture
+
+    int texture(const tinygltf::Model& m, int index, bool srgb, int& wrap, int shift) {
+        if (index < 0 || index >= (int)m.textures.size()) return -1;
+
+        const tinygltf::Texture& t = m.textures[index];
+        if (t.source < 0 || t.source >= (int)m.images.size()) return -1;
+
+        if (t.sampler >= 0 && t.sampler < (int)m.samplers.size()) {
+            const tinygltf::Sampler& s = m.samplers[t.sampler];
+            wrap |= (wrapMode(s.wrapS) | wrapMode(s.wrapT) << 2) << shift;
+        }
+
+        auto key = std::make_pair(t.source, srgb);
+        auto found = byImage.find(key);
+        if (found != byImage.end()) return found->second;
+
+        DecodedTexture d;
+        d.image = t.source;
+        d.srgb = srgb;
+        textures.push_back(d);
+        byImage[key] = (int)textures.size() - 1;
+        return (int)textures.size() - 1;
+    }
+
+    static int wrapMode(int gl) {
+        switch (gl) {
+            case 33071: return WRAP_CLAMP;      // CLAMP_TO_EDGE
+            case 33648: return WRAP_MIRROR;     // MIRRORED_REPEAT
+            default: return WRAP_REPEAT;
+        }
+    }
+
+    static void decode(const tinygltf::Image& img, DecodedTexture& out) {
+        if (img.width < 0) {
+            int w, h, ch;
+            unsigned char* data = stbi_load_from_memory(img.image.data(), (int)img.image.size(), &w, &h, &ch, 4);
+            if (!data) return;
+
+            out.rgba.assign(data, data + (size_t)w * h * 4);
+            out.width = w;
+            out.height = h;
+            stbi_image_free(data);
+            return;
+        }
+
+        // already decoded, 8 or 16 bit with 1..4 components
+        int comps = img.component, bytes = img.bits == 16 ? 2 : 1;
+        if (comps < 1 || comps > 4 || img.image.size() < (size_t)img.width * img.height * comps * bytes) return;
+
+        out.width = img.width;
+        out.height = img.height;
+        out.rgba.resize((size_t)img.width * img.height * 4);
+        for (size_t p = 0; p < (size_t)img.width * img.height; p++) {
+            const unsigned char* s = &img.image[p * comps * bytes];
+            unsigned char* d = &out.rgba[p * 4];
+            for (int c = 0; c < 4; c++) {
+                // gray (+ alpha) is spread over rgb, missing alpha is opaque
+                int from;
+                if (c < 3) from = comps >= 3 ? c : 0;
+                else from = comps == 2 ? 1 : comps == 4 ? 3 : -1;
+
+                d[c] = from < 0 ? 255 : s[from * bytes + bytes - 1];   // high byte of 16 bit
+            }
+        }
+    }
+};
@@ -0,0 +1,423 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+
+#include "workers.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TOGL_MESHLET_SSE 1
+#endif
+
+// a cluster of up to MAX_TRIANGLES triangles over at most MAX_VERTICES
+// vertices: a contiguous range of the index buffer with a bounding sphere
+// and a cone around the normals of its triangles
+struct Meshlet {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+    glm::vec3 coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    float coneCutoff = 1.0f;        // sin of the cone's spread, 1 = never back-facing
+    unsigned int firstIndex = 0, indexCount = 0;
+    unsigned int vertexCount = 0;
+};
+
+// meshlets of one mesh and their per-frame culling. build() clusters the
+// triangles and reorders the index buffer so every meshlet is one range.
+// cull() tests every meshlet of every instance against the frustum and
+// the back-facing cone (as in meshoptimizer's cluster bounds), 4 meshlets
+// at a time, over several threads, and leaves per instance the surviving
+// index ranges, neighbours merged, ready for glMultiDrawElements.
+//
+// the bounds are static: skinned meshes can't use this.
+class MeshletSet {
+public:
+    // what mesh shader hardware takes per workgroup; we only draw index
+    // ranges, the limits keep the clusters small and their cones tight
+    static const int MAX_VERTICES = 128;
+    static const int MAX_TRIANGLES = 124;
+
+    // below this many meshlet tests a frame stays on the calling thread
+    static const int PARALLEL_MIN_TESTS = 65536;
+
+    std::vector<Meshlet> meshlets;
+
+    // sphere around all meshlets, tested first
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+    size_t triangles = 0;
+
+    // last cull(), over all instances
+    size_t trianglesTested = 0, backfaceCulled = 0, frustumCulled = 0;
+    float cpuMs = 0.0f;
+
+    bool empty() const {
+        return meshlets.empty();
+    }
+
+    // V needs .pos and .material; triangles of a material flagged in
+    // twoSided can face either way and don't narrow the cone
+    template <typename V>
+    void build(const std::vector<V>& vertices, std::vector<unsigned int>& indices, const std::vector<char>& twoSided) {
+        meshlets.clear();
+        triangles = 0;
+        size_t tris = indices.size() / 3;
+        if (tris == 0) return;
+
+        // triangles around each vertex, CSR
+        std::vector<unsigned int> adjStart(vertices.size() + 1, 0), adj(tris * 3);
+        for (unsigned int i : indices) adjStart[i + 1]++;
+        for (size_t v = 0; v < vertices.size(); v++) adjStart[v + 1] += adjStart[v];
+        std::vector<unsigned int> fill(adjStart.begin(), adjStart.end() - 1);
+        for (size_t t = 0; t < tris; t++) {
+            for (int k = 0; k < 3; k++) adj[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+        }
+
+        // grow each meshlet breadth-first over shared vertices, so it stays
+        // a compact patch. a full meshlet restarts the front at its last
+        // triangle, the rest of the old front is picked up again later
+        std::vector<unsigned int> out;
+        out.reserve(indices.size());
+        std::vector<char> emitted(tris, 0), queued(tris, 0);
+        std::vector<int> stamp(vertices.size(), -1);
+        std::vector<unsigned int> queue;
+        size_t head = 0;
+
+        Meshlet m;
+        int meshletVerts = 0, meshletTris = 0;
+        auto flush = [&] {
+            if (meshletTris == 0) return;
+            m.indexCount = (unsigned int)(out.size() - m.firstIndex);
+            m.vertexCount = (unsigned int)meshletVerts;
+            bounds(vertices, out, twoSided, m);
+            meshlets.push_back(m);
+
+            m = Meshlet();
+            m.firstIndex = (unsigned int)out.size();
+            meshletVerts = meshletTris = 0;
+        };
+        auto push = [&](unsigned int t) {
+            for (int k = 0; k < 3; k++) {
+                unsigned int v = indices[t * 3 + k];
+                for (unsigned int a = adjStart[v]; a < adjStart[v + 1]; a++) {
+                    unsigned int u = adj[a];
+                    if (!emitted[u] && !queued[u]) {
+                        queued[u] = 1;
+                        queue.push_back(u);
+                    }
+                }
+            }
+        };
+
+        for (size_t seed = 0; seed < tris; seed++) {
+            if (emitted[seed]) continue;
+            queued[seed] = 1;
+            queue.push_back((unsigned int)seed);
+
+            while (head < queue.size()) {
+                unsigned int t = queue[head++];
+                queued[t] = 0;
+                if (emitted[t]) continue;
+
+                int id = (int)meshlets.size();
+                int fresh = 0;
+                for (int k = 0; k < 3; k++) fresh += stamp[indices[t * 3 + k]] != id ? 1 : 0;
+
+                if (meshletTris == MAX_TRIANGLES || meshletVerts + fresh > MAX_VERTICES) {
+                    flush();
+                    for (size_t q = head; q < queue.size(); q++) queued[queue[q]] = 0;
+                    queue.clear();
+                    head = 0;
+                    id = (int)meshlets.size();
+                    fresh = 3;
+                }
+
+                for (int k = 0; k < 3; k++) {
+                    unsigned int v = indices[t * 3 + k];
+                    if (stamp[v] != id) {
+                        stamp[v] = id;
+                        meshletVerts++;
+                    }
+                    out.push_back(v);
+                }
+                meshletTris++;
+                emitted[t] = 1;
+                push(t);
+            }
+            queue.clear();
+            head = 0;
+        }
+        flush();
+
+        indices.swap(out);
+        buildLanes();
+        triangles = tris;
+
+        glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+        for (const Meshlet& ml : meshlets) {
+            lo = glm::min(lo, ml.center - glm::vec3(ml.radius));
+            hi = glm::max(hi, ml.center + glm::vec3(ml.radius));
+        }
+        center = (lo + hi) * 0.5f;
+        radius = 0.0f;
+        for (const Meshlet& ml : meshlets) radius = std::max(radius, glm::length(ml.center - center) + ml.radius);
+    }
+
+    // instances: model matrices in draw order. planes (Camera::getFrustumPlanes)
+    // and eye in world space. threads = 0 uses every core
+    void cull(const glm::mat4* instances, int count, const glm::vec4* planes, const glm::vec3& eye, int threads = 0) {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+        ranges.resize(count);
+
+        if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        threads = std::max(1, std::min(threads, count));
+        if ((size_t)count * meshlets.size() < (size_t)PARALLEL_MIN_TESTS) threads = 1;
+        if ((int)lists.size() < threads) lists.resize(threads);
+
+        auto work = [&](int slot, int begin, int end) {
+            List& l = lists[slot];
+            l.counts.clear();
+            l.offsets.clear();
+            l.tested = l.back = l.frustum = 0;
+            for (int i = begin; i < end; i++) cullInstance(instances[i], planes, eye, slot, ranges[i]);
+        };
+
+        if (threads == 1) {
+            work(0, 0, count);
+        } else {
+            WorkerPool::get().run(threads, [&](int i) {
+                work(i, count * i / threads, count * (i + 1) / threads);
+            });
+        }
+
+        trianglesTested = backfaceCulled = frustumCulled = 0;
+        for (int i = 0; i < threads; i++) {
+            trianglesTested += lists[i].tested;
+            backfaceCulled += lists[i].back;
+            frustumCulled += lists[i].frustum;
+        }
+
+        cpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // surviving ranges of instance i after cull(), glMultiDrawElements
+    // arguments (index counts and byte offsets)
+    int drawCount(int i) const {
+        return ranges[i].count;
+    }
+
+    const int* counts(int i) const {
+        return lists[ranges[i].list].counts.data() + ranges[i].first;
+    }
+
+    const void* const* offsets(int i) const {
+        return lists[ranges[i].list].offsets.data() + ranges[i].first;
+    }
+
+    float culledFraction() const {
+        return trianglesTested ? (float)(backfaceCulled + frustumCulled) / trianglesTested : 0.0f;
+    }
+
+private:
+    // meshlet bounds as structure of arrays, padded to a multiple of 4.
+    // results of the padding lanes are never looked at
+    std::vector<float> cx, cy, cz, cr, ax, ay, az, ac;
+
+    // per thread: draw ranges of the instances it culled
+    struct List {
+        std::vector<int> counts;
+        std::vector<const void*> offsets;
+        size_t tested = 0, back = 0, frustum = 0;
+    };
+    std::vector<List> lists;
+
+    struct Range {
+        int list = 0, first = 0, count = 0;
+    };
+    std::vector<Range> ranges;
+
+    template <typename V>
+    static void bounds(const std::vector<V>& vertices, const std::vector<unsigned int>& out,
+                       const std::vector<char>& twoSided, Meshlet& m) {
+        const unsigned int* idx = out.data() + m.firstIndex;
+
+        glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+        for (unsigned int i = 0; i < m.indexCount; i++) {
+            lo = glm::min(lo, vertices[idx[i]].pos);
+            hi = glm::max(hi, vertices[idx[i]].pos);
+        }
+        m.center = (lo + hi) * 0.5f;
+        m.radius = 0.0f;
+        for (unsigned int i = 0; i < m.indexCount; i++) {
+            m.radius = std::max(m.radius, glm::length(vertices[idx[i]].pos - m.center));
+        }
+
+        // cone: mean normal, spread from the widest triangle. glTF fronts
+        // are counter-clockwise
+        std::vector<glm::vec3> normals;
+        normals.reserve(m.indexCount / 3);
+        glm::vec3 sum(0.0f);
+        bool cone = true;
+        for (unsigned int i = 0; i + 2 < m.indexCount; i += 3) {
+            const V& a = vertices[idx[i]];
+            glm::vec3 n = glm::cross(vertices[idx[i + 1]].pos - a.pos, vertices[idx[i + 2]].pos - a.pos);
+            float len = glm::length(n);
+            if (a.material < twoSided.size() && twoSided[a.material]) cone = false;
+            if (len <= 0.0f) continue;
+            normals.push_back(n / len);
+            sum += n / len;
+        }
+
+        m.coneCutoff = 1.0f;
+        float sumLen = glm::length(sum);
+        if (!cone || normals.empty() || sumLen <= 1e-6f) return;
+
+        m.coneAxis = sum / sumLen;
+        float minDot = 1.0f;
+        for (const glm::vec3& n : normals) minDot = std::min(minDot, glm::dot(n, m.coneAxis));
+
+        // past ~84 degrees the test would never pass
+        if (minDot > 0.1f) m.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+    void buildLanes() {
+        size_t n = (meshlets.size() + 3) & ~(size_t)3;
+        for (std::vector<float>* v : { &cx, &cy, &cz, &cr, &ax, &ay, &az, &ac }) v->assign(n, 0.0f);
+
+        for (size_t i = 0; i < meshlets.size(); i++) {
+            const Meshlet& m = meshlets[i];
+            cx[i] = m.center.x; cy[i] = m.center.y; cz[i] = m.center.z; cr[i] = m.radius;
+            ax[i] = m.coneAxis.x; ay[i] = m.coneAxis.y; az[i] = m.coneAxis.z; ac[i] = m.coneCutoff;
+        }
+    }
+
+    // the frustum planes go into object space (p' = M^T p keeps the world
+    // distance), the eye through the inverse; the radius scales with the
+    // largest axis of the instance
+    void cullInstance(const glm::mat4& model, const glm::vec4* worldPlanes, const glm::vec3& worldEye,
+                      int slot, Range& range) {
+        List& l = lists[slot];
+        range.list = slot;
+        range.first = (int)l.counts.size();
+
+        glm::mat4 mt = glm::transpose(model);
+        glm::vec4 p[6];
+        for (int k = 0; k < 6; k++) p[k] = mt * worldPlanes[k];
+
+        glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(worldEye, 1.0f));
+        float scale = std::max(glm::length(glm::vec3(model[0])),
+                               std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+
+        // whole instance outside one plane, or inside all of them
+        bool inside = true;
+        for (int k = 0; k < 6; k++) {
+            float d = glm::dot(glm::vec3(p[k]), center) + p[k].w;
+            if (d < -radius * scale) {
+                l.tested += triangles;
+                l.frustum += triangles;
+                range.count = 0;
+                return;
+            }
+            if (d < radius * scale) inside = false;
+        }
+
+        size_t lanes = cx.size();
+        unsigned int pendingFirst = 0, pendingEnd = 0;
+
+        for (size_t b = 0; b < lanes; b += 4) {
+            int outside, back;
+            testBlock(b, inside ? 0 : 6, p, eye, scale, outside, back);
+
+            for (int k = 0; k < 4 && b + k < meshlets.size(); k++) {
+                const Meshlet& m = meshlets[b + k];
+                unsigned int tris = m.indexCount / 3;
+                l.tested += tris;
+
+                if (outside & (1 << k)) { l.frustum += tris; continue; }
+                if (back & (1 << k)) { l.back += tris; continue; }
+
+                // neighbouring survivors become one range
+                if (pendingEnd == m.firstIndex && pendingEnd != pendingFirst) {
+                    pendingEnd += m.indexCount;
+                    continue;
+                }
+                if (pendingEnd != pendingFirst) emit(l, pendingFirst, pendingEnd);
+                pendingFirst = m.firstIndex;
+                pendingEnd = m.firstIndex + m.indexCount;
+            }
+        }
+        if (pendingEnd != pendingFirst) emit(l, pendingFirst, pendingEnd);
+
+        range.count = (int)l.counts.size() - range.first;
+    }
+
+    static void emit(List& l, unsigned int first, unsigned int end) {
+        l.counts.push_back((int)(end - first));
+        l.offsets.push_back((const void*)((uintptr_t)first * sizeof(unsigned int)));
+    }
+
+    // bit k of outside/back for meshlet b + k, against the first planes of p
+    void testBlock(size_t b, int planes, const glm::vec4* p, const glm::vec3& eye, float scale,
+                   int& outside, int& back) const {
+#ifdef TOGL_MESHLET_SSE
+        __m128 x = _mm_loadu_ps(&cx[b]), y = _mm_loadu_ps(&cy[b]), z = _mm_loadu_ps(&cz[b]), r = _mm_loadu_ps(&cr[b]);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(r, _mm_set1_ps(scale)));
+
+        __m128 out = _mm_setzero_ps();
+        for (int k = 0; k < planes; k++) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(p[k].x)), _mm_mul_ps(y, _mm_set1_ps(p[k].y))),
+                                  _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(p[k].z)), _mm_set1_ps(p[k].w)));
+            out = _mm_or_ps(out, _mm_cmplt_ps(d, negR));
+        }
+        outside = _mm_movemask_ps(out);
+
+        // back-facing: dot(c - eye, axis) >= cutoff * |c - eye| + r
+        __m128 vx = _mm_sub_ps(x, _mm_set1_ps(eye.x));
+        __m128 vy = _mm_sub_ps(y, _mm_set1_ps(eye.y));
+        __m128 vz = _mm_sub_ps(z, _mm_set1_ps(eye.z));
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_loadu_ps(&ax[b])), _mm_mul_ps(vy, _mm_loadu_ps(&ay[b]))),
+                              _mm_mul_ps(vz, _mm_loadu_ps(&az[b])));
+        back = _mm_movemask_ps(_mm_cmpge_ps(d, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&ac[b]), len), r)));
+#else
+        outside = back = 0;
+        for (int k = 0; k < 4; k++) {
+            size_t i = b + k;
+            glm::vec3 c(cx[i], cy[i], cz[i]);
+            for (int j = 0; j < planes; j++) {
+                if (glm::dot(glm::vec3(p[j]), c) + p[j].w < -cr[i] * scale) outside |= 1 << k;
+            }
+
+            glm::vec3 v = c - eye;
+            if (glm::dot(v, glm::vec3(ax[i], ay[i], az[i])) >= ac[i] * glm::length(v) + cr[i]) back |= 1 << k;
+        }
+#endif
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
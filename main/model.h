@@ -4,20 +4,82 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <tiny_gltf.h>
+#include "render/MemoryRegistry.h"
+#include "render/TexturePools.h"
+#include "scenegraph.h"
+#include "animation.h"
+#include "material.h"
+#include "profiler.h"
+#include "meshlet.h"
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <cstddef>
+#include <cfloat>
 
 class Model {
 public:
-    unsigned int VAO, VBO, EBO;
+    unsigned int VAO = 0, VBO = 0, EBO = 0;
+    unsigned int skinVBO = 0;   // joints + weights, only for skinned meshes
+    unsigned int materialUBO = 0;
     size_t indexCount = 0;
     float rotationY = 0.0f;
 
+    // object space bounds of the mesh
+    glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+
+    // node hierarchy of the file and the nodes that draw the mesh
+    SceneGraph graph;
+    std::vector<int> meshNodes;
+
+    // skin and animations, see animation.h
+    Skeleton skeleton;
+    std::vector<AnimationClip> clips;
+    CrowdAnimator crowd;
+    int clip = 0;
+
+    // materials of the mesh, textures live in a few array pools
+    std::vector<MaterialData> materials;
+    TexturePools texturePools;
+
+    // clusters of the index buffer for per-instance culling, empty for
+    // skinned meshes
+    MeshletSet meshlets;
+
     Model(const std::string& path) {
         loadModel(path);
     }
 
+    ~Model() {
+        MemoryRegistry& mem = MemoryRegistry::get();
+        mem.release(MemoryRegistry::BUFFER, VBO);
+        mem.release(MemoryRegistry::BUFFER, EBO);
+        mem.release(MemoryRegistry::BUFFER, skinVBO);
+        mem.release(MemoryRegistry::BUFFER, materialUBO);
+
+        if (VAO) glDeleteVertexArrays(1, &VAO);
+        if (VBO) glDeleteBuffers(1, &VBO);
+        if (EBO) glDeleteBuffers(1, &EBO);
+        if (skinVBO) glDeleteBuffers(1, &skinVBO);
+        if (materialUBO) glDeleteBuffers(1, &materialUBO);
+    }
+
+    bool skinned() const {
+        return skinVBO != 0;
+    }
+
+    bool animated() const {
+        return !clips.empty();
+    }
+
+    // material block on uboBinding, texture pools from firstUnit on. stays
+    // valid for every draw of the mesh, whatever materials it mixes
+    void bindMaterials(GLuint uboBinding, int firstUnit) const {
+        if (materialUBO) glBindBufferBase(GL_UNIFORM_BUFFER, uboBinding, materialUBO);
+        texturePools.bind(firstUnit);
+    }
+
     void update(float dt) {
         rotationY += dt * 0.5f;  // auto-turn
     }
@@ -28,7 +90,69 @@ public:
         glBindVertexArray(0);
     }
 
-glm::mat4 getModelMatrix(float rotationX) {
+    // model matrices come from instanceBuffer at offset, one mat4 per
+    // instance. skinned meshes also need paletteOffset: one int per
+    // instance with the first texel of its bone palette
+    void drawInstanced(GLuint instanceBuffer, GLintptr offset, int count, GLintptr paletteOffset = -1) {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        bindInstances(offset, paletteOffset);
+
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, count);
+        glBindVertexArray(0);
+    }
+
+    // instances [first, first + count) of the last meshlets.cull(), each
+    // with the index ranges that survived it. offset is where instance 0's
+    // matrix sits in instanceBuffer
+    void drawMeshlets(GLuint instanceBuffer, GLintptr offset, int first, int count) {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+        for (int i = first; i < first + count; i++) {
+            int draws = meshlets.drawCount(i);
+            if (draws == 0) continue;
+
+            // not an instanced draw: every vertex reads the first instance
+            bindInstances(offset + i * (GLintptr)sizeof(glm::mat4), -1);
+            glMultiDrawElements(GL_TRIANGLES, meshlets.counts(i), GL_UNSIGNED_INT, meshlets.offsets(i), draws);
+        }
+        glBindVertexArray(0);
+    }
+
+    // getModelMatrix() was tuned for the mesh in its own space, so the
+    // graph is anchored on the first node drawing it: the bundled asset
+    // looks the same and other nodes keep their place relative to it.
+    // skinned meshes ignore their node, the joints place them (glTF spec)
+    glm::mat4 nodeMatrix(int node) const {
+        return skinned() ? anchor : anchor * graph.world[node];
+    }
+
+    // node animation of unskinned files: clip at time moves the graph
+    // nodes, every instance shares the pose
+    void animate(float time) {
+        if (!animated() || skinned()) return;
+        if (crowd.characters != 1) crowd.resize(skeleton, 1);
+
+        crowd.evaluate(skeleton, clips[clip], &time);
+        crowd.applyToGraph(skeleton, clips[clip], graph, 0);
+    }
+
+    // skinned: one pose per character at times[c], bone palettes written
+    // to dst (count * joints * 12 floats)
+    void animateCrowd(const float* times, int count, float* dst) {
+        if (!skinned()) return;
+        if (crowd.characters != count) crowd.resize(skeleton, count);
+
+        if (animated()) {
+            crowd.evaluate(skeleton, clips[clip], times, dst);
+        } else {
+            static const AnimationClip restPose;
+            crowd.evaluate(skeleton, restPose, times, dst);
+        }
+    }
+
+static glm::mat4 getModelMatrix(float rotationX) {
     glm::mat4 m(1.0f);
 
     m = glm::rotate(m, glm::radians(-90.0f), glm::vec3(1,0,0));
@@ -43,73 +167,373 @@ glm::mat4 getModelMatrix(float rotationX) {
 }
 
 
-private:
-    void loadModel(const std::string& path) {
+    struct Vertex { glm::vec3 pos; glm::vec3 normal; glm::vec2 uv; unsigned int material; };
+    struct SkinVertex { unsigned short joints[4]; float weights[4]; };
+
+    // CPU side of the loaded primitive. decoding is kept apart from the GL
+    // upload so it can run (and be benchmarked) without a context
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+        SceneGraph graph;
+
+        std::vector<SkinVertex> skin;   // empty unless the mesh node has a skin
+        Skeleton skeleton;
+        std::vector<AnimationClip> clips;
+
+        MaterialSet materials;          // Vertex::material indexes materials.materials
+        MeshletSet meshlets;            // indices are in meshlet order once built
+    };
+
+    static bool decodeGLB(const unsigned char* bytes, size_t size, MeshData& out) {
         tinygltf::Model gltfModel;
         tinygltf::TinyGLTF loader;
+        loader.SetImageLoader(MaterialSet::KeepEncodedImage, nullptr);
         std::string err, warn;
 
-        bool ok = loader.LoadBinaryFromFile(&gltfModel, &err, &warn, path);
-        if(!warn.empty()) std::cout << "GLTF Warning: " << warn << "\n";
+        bool ok = loader.LoadBinaryFromMemory(&gltfModel, &err, &warn, bytes, (unsigned int)size);
         if(!err.empty())  std::cout << "GLTF Error:   " << err << "\n";
-        if(!ok) {
-            std::cout << "Failed to load GLB: " << path << "\n";
-            return;
+        if(!ok) return false;
+
+        return decode(gltfModel, out);
+    }
+
+    static bool decode(const tinygltf::Model& gltfModel, MeshData& out) {
+        if (gltfModel.meshes.empty() || gltfModel.meshes[0].primitives.empty()) {
+            std::cout << "GLTF Error:   no mesh\n";
+            return false;
+        }
+
+        // a reused MeshData keeps its capacity
+        out.vertices.clear();
+        out.indices.clear();
+        out.skin.clear();
+        out.skeleton = Skeleton();
+        out.clips.clear();
+        out.materials = MaterialSet();
+        out.meshlets = MeshletSet();
+
+        if (!out.graph.build(gltfModel)) std::cout << "GLTF Warning: broken node hierarchy, ignored\n";
+
+        // every triangle primitive of the mesh goes into one vertex and index
+        // buffer. vertices carry their material, so the mesh stays one draw
+        std::vector<const tinygltf::Primitive*> primitives;
+        for (const tinygltf::Primitive& primitive : gltfModel.meshes[0].primitives) {
+            if (primitive.mode != TINYGLTF_MODE_TRIANGLES && primitive.mode != -1) {
+                std::cout << "GLTF Warning: primitive mode " << primitive.mode << " skipped\n";
+                continue;
+            }
+            if (primitive.attributes.find("POSITION") == primitive.attributes.end() || primitive.indices < 0) {
+                std::cout << "GLTF Error:   primitive without POSITION or indices\n";
+                return false;
+            }
+            primitives.push_back(&primitive);
+        }
+        if (primitives.empty()) {
+            std::cout << "GLTF Error:   no triangles\n";
+            return false;
+        }
+
+        out.boundsMin = glm::vec3(FLT_MAX);
+        out.boundsMax = glm::vec3(-FLT_MAX);
+        for (const tinygltf::Primitive* primitive : primitives) {
+            if (!decodePrimitive(gltfModel, *primitive, out)) return false;
+        }
+
+        if (!decodeAnimation(gltfModel, primitives, out)) {
+            std::cout << "GLTF Warning: bad skin or animation, ignored\n";
+            out.skin.clear();
+            out.skeleton = Skeleton();
+            out.clips.clear();
+        }
+
+        // skinned vertices move, their clusters' bounds wouldn't hold
+        if (out.skin.empty()) {
+            std::vector<char> twoSided;
+            for (const MaterialData& m : out.materials.materials) twoSided.push_back(m.doubleSided ? 1 : 0);
+            out.meshlets.build(out.vertices, out.indices, twoSided);
         }
 
-        const tinygltf::Mesh& mesh = gltfModel.meshes[0];
-        const tinygltf::Primitive& primitive = mesh.primitives[0];
+        out.materials.decodeImages(gltfModel);
+        for (const DecodedTexture& t : out.materials.textures) {
+            if (t.width == 0) std::cout << "GLTF Warning: image " << t.image << " could not be decoded\n";
+        }
+        return true;
+    }
+
+private:
+    glm::mat4 anchor = glm::mat4(1.0f);
+
+    // per-instance attributes of the VAO (bound) from the buffer bound to
+    // GL_ARRAY_BUFFER: matrix at offset, palette texel at paletteOffset
+    void bindInstances(GLintptr offset, GLintptr paletteOffset) {
+        if (skinned() && paletteOffset >= 0) {
+            glEnableVertexAttribArray(9);
+            glVertexAttribIPointer(9, 1, GL_INT, sizeof(int), (void*)paletteOffset);
+            glVertexAttribDivisor(9, 1);
+        }
+
+        for (int i = 0; i < 4; i++) {
+            glEnableVertexAttribArray(3 + i);
+            glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (void*)(offset + i * sizeof(glm::vec4)));
+            glVertexAttribDivisor(3 + i, 1);
+        }
+    }
 
-        const tinygltf::Accessor& posAccessor   = gltfModel.accessors[primitive.attributes.at("POSITION")];
-        const tinygltf::BufferView& posView     = gltfModel.bufferViews[posAccessor.bufferView];
-        const tinygltf::Buffer& posBuffer       = gltfModel.buffers[posView.buffer];
+    // appends one primitive: vertices tagged with its material, indices
+    // rebased onto the vertices already there
+    static bool decodePrimitive(const tinygltf::Model& gltfModel, const tinygltf::Primitive& primitive, MeshData& out) {
+        const tinygltf::Accessor& posAccessor = gltfModel.accessors[primitive.attributes.at("POSITION")];
 
         const tinygltf::Accessor* normalAccessor = nullptr;
         if (primitive.attributes.find("NORMAL") != primitive.attributes.end()) {
             normalAccessor = &gltfModel.accessors[primitive.attributes.at("NORMAL")];
         }
 
-        const tinygltf::Accessor* uvAccessor = nullptr;
+        // TEXCOORD_0 is float or normalized unsigned byte/short (gltfpack
+        // and others quantize it), decoded to floats up front
+        std::vector<float> uvs;
+        bool uvOk = true;
         if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end()) {
-            uvAccessor = &gltfModel.accessors[primitive.attributes.at("TEXCOORD_0")];
+            int uvIndex = primitive.attributes.at("TEXCOORD_0");
+            const tinygltf::Accessor& uvAccessor = gltfModel.accessors[uvIndex];
+
+            bool quantized = uvAccessor.normalized && (uvAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+                                                       uvAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT);
+            if (uvAccessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT && !quantized) {
+                std::cout << "GLTF Error:   unsupported TEXCOORD_0 type\n";
+                return false;
+            }
+            uvOk = ReadAccessorFloats(gltfModel, uvIndex, 2, uvs) && uvAccessor.count >= posAccessor.count;
         }
 
         const tinygltf::Accessor& indexAccessor = gltfModel.accessors[primitive.indices];
-        const tinygltf::BufferView& indexView   = gltfModel.bufferViews[indexAccessor.bufferView];
-        const tinygltf::Buffer& indexBuffer     = gltfModel.buffers[indexView.buffer];
 
-        indexCount = indexAccessor.count;
+        // resolve views once, not per vertex
+        size_t posStride = 0, normalStride = 0, indexStride = 0;
+        size_t indexSize = (size_t)tinygltf::GetComponentSizeInBytes(indexAccessor.componentType);
+        const unsigned char* pos    = accessorData(gltfModel, posAccessor, sizeof(glm::vec3), posStride);
+        const unsigned char* normal = normalAccessor ? accessorData(gltfModel, *normalAccessor, sizeof(glm::vec3), normalStride) : nullptr;
+        const unsigned char* index  = accessorData(gltfModel, indexAccessor, indexSize, indexStride);
+
+        // attributes are read for every position
+        bool attributesOk = uvOk && (!normalAccessor || (normal && normalAccessor->count >= posAccessor.count));
+
+        if (!pos || !index || !attributesOk) {
+            std::cout << "GLTF Error:   bad accessor\n";
+            return false;
+        }
 
-        struct Vertex { glm::vec3 pos; glm::vec3 normal; glm::vec2 uv; };
-        std::vector<Vertex> vertices(posAccessor.count);
+        const size_t base = out.vertices.size();
+        const unsigned int material = (unsigned int)out.materials.add(gltfModel, primitive.material);
 
+        out.vertices.resize(base + posAccessor.count);
         for (size_t i = 0; i < posAccessor.count; i++) {
-            float* pos = (float*)(&posBuffer.data[posView.byteOffset + posAccessor.byteOffset + i * sizeof(glm::vec3)]);
-            vertices[i].pos = glm::vec3(pos[0], pos[1], pos[2]);
-
-            if (normalAccessor) {
-                const tinygltf::BufferView& nView = gltfModel.bufferViews[normalAccessor->bufferView];
-                const tinygltf::Buffer& nBuffer   = gltfModel.buffers[nView.buffer];
-                float* normal = (float*)(&nBuffer.data[nView.byteOffset + normalAccessor->byteOffset + i * sizeof(glm::vec3)]);
-                vertices[i].normal = glm::vec3(normal[0], normal[1], normal[2]);
+            Vertex& v = out.vertices[base + i];
+            memcpy(&v.pos, pos + i * posStride, sizeof(glm::vec3));
+            out.boundsMin = glm::min(out.boundsMin, v.pos);
+            out.boundsMax = glm::max(out.boundsMax, v.pos);
+
+            if (normal) {
+                memcpy(&v.normal, normal + i * normalStride, sizeof(glm::vec3));
             } else {
-                vertices[i].normal = glm::vec3(0,1,0);
+                v.normal = glm::vec3(0,1,0);
             }
 
-            if (uvAccessor) {
-                const tinygltf::BufferView& uvView = gltfModel.bufferViews[uvAccessor->bufferView];
-                const tinygltf::Buffer& uvBuffer   = gltfModel.buffers[uvView.buffer];
-                float* uv = (float*)(&uvBuffer.data[uvView.byteOffset + uvAccessor->byteOffset + i * sizeof(glm::vec2)]);
-                vertices[i].uv = glm::vec2(uv[0], uv[1]);
+            if (!uvs.empty()) {
+                v.uv = glm::vec2(uvs[i * 2], uvs[i * 2 + 1]);
             } else {
-                vertices[i].uv = glm::vec2(0,0);
+                v.uv = glm::vec2(0,0);
+            }
+
+            v.material = material;
+        }
+
+        const size_t first = out.indices.size();
+        out.indices.resize(first + indexAccessor.count);
+        unsigned int* dst = out.indices.data() + first;
+
+        switch (indexAccessor.componentType) {
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                if (indexStride == sizeof(unsigned int)) {
+                    memcpy(dst, index, indexAccessor.count * sizeof(unsigned int));
+                } else {
+                    for (size_t i = 0; i < indexAccessor.count; i++) memcpy(&dst[i], index + i * indexStride, 4);
+                }
+                break;
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                for (size_t i = 0; i < indexAccessor.count; i++) {
+                    unsigned short s;
+                    memcpy(&s, index + i * indexStride, sizeof(s));
+                    dst[i] = s;
+                }
+                break;
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                for (size_t i = 0; i < indexAccessor.count; i++) dst[i] = index[i * indexStride];
+                break;
+            default:
+                std::cout << "GLTF Error:   unsupported index type\n";
+                return false;
+        }
+
+        // indices past the vertices would be read on the GPU and walked on
+        // the CPU (meshlet adjacency), reject the file instead
+        for (size_t i = 0; i < indexAccessor.count; i++) {
+            if (dst[i] >= posAccessor.count) {
+                std::cout << "GLTF Error:   index out of range\n";
+                return false;
+            }
+            dst[i] += (unsigned int)base;
+        }
+        return true;
+    }
+
+    // skin of the first node drawing mesh 0, the vertex weights of every
+    // primitive, and the animations of the file
+    static bool decodeAnimation(const tinygltf::Model& m, const std::vector<const tinygltf::Primitive*>& primitives,
+                                MeshData& out) {
+        int skin = -1;
+        for (int i = 0; i < out.graph.count(); i++) {
+            if (out.graph.mesh[i] == 0) {
+                skin = m.nodes[out.graph.source[i]].skin;
+                break;
+            }
+        }
+
+        // all primitives need weights, a partly skinned mesh is drawn rigid
+        for (const tinygltf::Primitive* p : primitives) {
+            if (p->attributes.find("JOINTS_0") == p->attributes.end() ||
+                p->attributes.find("WEIGHTS_0") == p->attributes.end()) skin = -1;
+        }
+
+        if (skin < 0 && m.animations.empty()) return true;
+        if (!out.skeleton.build(m, out.graph, skin)) return false;
+        out.skeleton.loadClips(m, out.graph, out.clips);
+
+        if (skin < 0) return true;
+
+        int jointCount = out.skeleton.jointCount();
+        std::vector<float> j, w;
+        for (const tinygltf::Primitive* p : primitives) {
+            size_t vertexCount = m.accessors[p->attributes.at("POSITION")].count;
+            if (!ReadAccessorFloats(m, p->attributes.at("JOINTS_0"), 4, j) ||
+                !ReadAccessorFloats(m, p->attributes.at("WEIGHTS_0"), 4, w)) return false;
+            if (j.size() != vertexCount * 4 || w.size() != vertexCount * 4) return false;
+
+            size_t base = out.skin.size();
+            out.skin.resize(base + vertexCount);
+            for (size_t i = 0; i < vertexCount; i++) {
+                SkinVertex& v = out.skin[base + i];
+                float sum = w[i * 4] + w[i * 4 + 1] + w[i * 4 + 2] + w[i * 4 + 3];
+
+                for (int k = 0; k < 4; k++) {
+                    int joint = (int)j[i * 4 + k];
+                    if (joint >= jointCount) return false;
+
+                    v.joints[k] = (unsigned short)joint;
+                    v.weights[k] = sum > 0.0f ? w[i * 4 + k] / sum : (k == 0 ? 1.0f : 0.0f);
+                }
             }
         }
+        return true;
+    }
+
+    // first element of the accessor, nullptr unless all a.count elements
+    // of elementSize bytes lie inside its view and the view inside its buffer
+    static const unsigned char* accessorData(const tinygltf::Model& m, const tinygltf::Accessor& a,
+                                             size_t elementSize, size_t& stride) {
+        if (a.bufferView < 0 || a.bufferView >= (int)m.bufferViews.size()) return nullptr;
+
+        const tinygltf::BufferView& view = m.bufferViews[a.bufferView];
+        if (view.buffer < 0 || view.buffer >= (int)m.buffers.size()) return nullptr;
+
+        const std::vector<unsigned char>& data = m.buffers[view.buffer].data;
+        if (view.byteOffset > data.size() || view.byteLength > data.size() - view.byteOffset) return nullptr;
+
+        int s = a.ByteStride(view);
+        if (s <= 0) return nullptr;
+
+        // count <= byteLength keeps the product below from overflowing
+        if (a.count > view.byteLength || a.byteOffset > view.byteLength) return nullptr;
+        if (a.count && (a.count - 1) * (size_t)s + elementSize > view.byteLength - a.byteOffset) return nullptr;
+
+        stride = (size_t)s;
+        return data.data() + view.byteOffset + a.byteOffset;
+    }
+
+    void loadModel(const std::string& path) {
+        PROFILE_SCOPE("Model::loadModel");
+        MemoryRegistry::LoadScope scope("model " + path);
+        MemoryRegistry& mem = MemoryRegistry::get();
+
+        tinygltf::Model gltfModel;
+        tinygltf::TinyGLTF loader;
+        loader.SetImageLoader(MaterialSet::KeepEncodedImage, nullptr);
+        std::string err, warn;
+
+        bool ok;
+        {
+            PROFILE_SCOPE("parse glb");
+            ok = loader.LoadBinaryFromFile(&gltfModel, &err, &warn, path);
+        }
+        if(!warn.empty()) std::cout << "GLTF Warning: " << warn << "\n";
+        if(!err.empty())  std::cout << "GLTF Error:   " << err << "\n";
+        if(!ok) {
+            std::cout << "Failed to load GLB: " << path << "\n";
+            return;
+        }
+
+        size_t parsedBytes = 0;
+        for (const tinygltf::Buffer& b : gltfModel.buffers) parsedBytes += b.data.size();
+        for (const tinygltf::Image& img : gltfModel.images) parsedBytes += img.image.size();
+        mem.cpuAlloc(parsedBytes);
+
+        MeshData data;
+        bool decoded;
+        {
+            PROFILE_SCOPE("decode");
+            decoded = decode(gltfModel, data);
+        }
+        if (!decoded) {
+            std::cout << "Failed to load GLB: " << path << "\n";
+            return;
+        }
 
+        size_t decodedBytes = 0;
+        for (const DecodedTexture& t : data.materials.textures) decodedBytes += t.rgba.capacity();
+        mem.cpuAlloc(data.vertices.capacity() * sizeof(Vertex) + data.indices.capacity() * sizeof(unsigned int) +
+                     data.skin.capacity() * sizeof(SkinVertex) + decodedBytes);
 
-        std::vector<unsigned int> indices(indexCount);
-        memcpy(indices.data(), &indexBuffer.data[indexView.byteOffset + indexAccessor.byteOffset], indexCount * sizeof(unsigned int));
+        {
+            PROFILE_SCOPE("upload");
+            upload(data);
+        }
+
+        graph = std::move(data.graph);
+        skeleton = std::move(data.skeleton);
+        clips = std::move(data.clips);
+        materials = std::move(data.materials.materials);
+        meshlets = std::move(data.meshlets);
+        for (int i = 0; i < graph.count(); i++) {
+            if (graph.mesh[i] == 0) meshNodes.push_back(i);
+        }
+        if (meshNodes.empty()) {
+            meshNodes.push_back(graph.addNode(-1, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f), 0));
+            graph.update(1);
+        }
+        anchor = glm::inverse(graph.world[meshNodes[0]]);
 
+        std::cout << "GLB Loaded: " << path << " (" << graph.count() << " nodes, " << skeleton.jointCount()
+                  << " joints, " << clips.size() << " animations, " << materials.size() << " materials, "
+                  << texturePools.pools.size() << " texture pools, " << meshlets.meshlets.size() << " meshlets)\n";
+    }
+
+    void upload(const MeshData& data) {
+        indexCount = data.indices.size();
+        boundsMin = data.boundsMin;
+        boundsMax = data.boundsMax;
 
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -118,10 +542,12 @@ private:
         glBindVertexArray(VAO);
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+        MemoryRegistry::get().bufferData("model vertices", GL_ARRAY_BUFFER, VBO,
+            data.vertices.size() * sizeof(Vertex), data.vertices.data(), GL_STATIC_DRAW);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        MemoryRegistry::get().bufferData("model indices", GL_ELEMENT_ARRAY_BUFFER, EBO,
+            data.indices.size() * sizeof(unsigned int), data.indices.data(), GL_STATIC_DRAW);
 
 
         glEnableVertexAttribArray(0); // pos
@@ -133,9 +559,63 @@ private:
         glEnableVertexAttribArray(2); // uv
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
 
+        glEnableVertexAttribArray(10); // material
+        glVertexAttribIPointer(10, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)offsetof(Vertex, material));
+
+        // 3..6 are the instance matrix, 9 the palette offset
+        if (!data.skin.empty()) {
+            glGenBuffers(1, &skinVBO);
+            glBindBuffer(GL_ARRAY_BUFFER, skinVBO);
+            MemoryRegistry::get().bufferData("model skin", GL_ARRAY_BUFFER, skinVBO,
+                data.skin.size() * sizeof(SkinVertex), data.skin.data(), GL_STATIC_DRAW);
+
+            glEnableVertexAttribArray(7); // joints
+            glVertexAttribIPointer(7, 4, GL_UNSIGNED_SHORT, sizeof(SkinVertex), (void*)offsetof(SkinVertex, joints));
+
+            glEnableVertexAttribArray(8); // weights
+            glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, weights));
+        }
+
         glBindVertexArray(0);
 
-        std::cout << "GLB Loaded: " << path << "\n";
+        uploadMaterials(data.materials);
+    }
+
+    // textures into the array pools, then one std140 entry per material
+    void uploadMaterials(const MaterialSet& set) {
+        std::vector<TexturePools::Image> images(set.textures.size());
+        for (size_t i = 0; i < set.textures.size(); i++) {
+            const DecodedTexture& t = set.textures[i];
+            images[i].width = t.width;
+            images[i].height = t.height;
+            images[i].srgb = t.srgb;
+            images[i].rgba = t.width ? t.rgba.data() : nullptr;
+        }
+        std::vector<TexturePools::Slot> slots = texturePools.build(images);
+
+        auto slot = [&](int texture) {
+            return texture >= 0 ? slots[texture] : TexturePools::Slot();
+        };
+
+        // always the full block, a shorter buffer would leave reads past it undefined
+        std::vector<MaterialUniforms> block(MaterialSet::MAX_MATERIALS);
+        for (size_t i = 0; i < set.materials.size(); i++) {
+            const MaterialData& m = set.materials[i];
+            TexturePools::Slot base = slot(m.baseColorTexture);
+            TexturePools::Slot normal = slot(m.normalTexture);
+            TexturePools::Slot metalRough = slot(m.metalRoughTexture);
+
+            block[i].baseColor = m.baseColor;
+            block[i].factors = glm::vec4(m.metallic, m.roughness, m.normalScale, m.alphaCutoff);
+            block[i].baseAndNormal = glm::ivec4(base.pool, base.layer, normal.pool, normal.layer);
+            block[i].metalRough = glm::ivec4(metalRough.pool, metalRough.layer, m.wrap, m.doubleSided ? 1 : 0);
+        }
+
+        glGenBuffers(1, &materialUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, materialUBO);
+        MemoryRegistry::get().bufferData("model materials", GL_UNIFORM_BUFFER, materialUBO,
+            block.size() * sizeof(MaterialUniforms), block.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
     }
 };
 
@@ -0,0 +1,83 @@
+#pragma once
+#include <new>
+#include <cstdlib>
+#include <algorithm>
+
+#include "arena.h"
+
+// replaces the global operator new/delete to count every C++ heap
+// allocation in AllocationCounter. these are definitions, include this
+// in exactly one .cpp of a program (main.cpp, togl_bench.cpp)
+
+inline void* CountedAlloc(size_t size) {
+    AllocationCounter::add(size);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+inline void* CountedAlignedAlloc(size_t size, size_t align) {
+    AllocationCounter::add(size);
+    if (size == 0) size = 1;
+#ifdef _WIN32
+    void* p = _aligned_malloc(size, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, std::max(align, sizeof(void*)), size) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+inline void CountedAlignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    AllocationCounter::add(size);
+    return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    AllocationCounter::add(size);
+    return malloc(size ? size : 1);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+void* operator new(size_t size, std::align_val_t a) { return CountedAlignedAlloc(size, (size_t)a); }
+void* operator new[](size_t size, std::align_val_t a) { return CountedAlignedAlloc(size, (size_t)a); }
+void operator delete(void* p, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { CountedAlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { CountedAlignedFree(p); }
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,261 @@
+#pragma once
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+// frame-rate limiter: frame starts are spaced `period` apart on the
+// steady clock. sleep_for oversleeps by up to a scheduler tick (1-16 ms
+// depending on the OS), so it only sleeps to `slack` before the deadline
+// and spins the rest. slack follows the typical recent oversleep
+class FrameLimiter {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    int fps = 0;                // 0 = no limit
+    float waitMs = 0.0f;        // time the last wait() held the frame
+    float slackMs = 1.0f;       // spun, not slept, before each deadline
+
+    void wait() {
+        waitMs = 0.0f;
+        if (fps <= 0) {
+            scheduled = false;
+            return;
+        }
+
+        Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        Clock::time_point now = Clock::now();
+
+        // first frame, or a frame ran a whole period late: start over from
+        // now instead of rushing the next few to catch up
+        if (!scheduled || now - next > period) {
+            next = now;
+            scheduled = true;
+        }
+
+        if (now < next) {
+            std::chrono::duration<double, std::milli> slack(slackMs);
+            if (next - now > slack) {
+                Clock::duration sleep = std::chrono::duration_cast<Clock::duration>(next - now - slack);
+                Clock::time_point before = Clock::now();
+                std::this_thread::sleep_for(sleep);
+
+                // rises quickly to a steady oversleep (windows' 15.6 ms tick),
+                // one preempted sleep only nudges it
+                float over = std::chrono::duration<float, std::milli>(Clock::now() - before - sleep).count();
+                float target = std::max(over * 1.25f, MIN_SLACK_MS);
+                slackMs += (target - slackMs) * (target > slackMs ? 0.1f : 0.02f);
+            }
+            while (Clock::now() < next) std::this_thread::yield();
+
+            waitMs = std::chrono::duration<float, std::milli>(Clock::now() - now).count();
+        }
+        next += period;
+    }
+
+private:
+    static constexpr float MIN_SLACK_MS = 0.2f;
+
+    Clock::time_point next;
+    bool scheduled = false;
+};
+
+// presentation controls for the windowed loop:
+//
+//   limit(); glfwPollEvents(); beginFrame(); ...draw...; glfwSwapBuffers(); presented();
+//
+// - vsync off / on / adaptive (late frames tear instead of waiting a whole
+//   refresh, needs EXT_swap_control_tear, plain vsync without it)
+// - the frame-rate limit above
+// - at most maxFramesInFlight frames queued on the GPU: beginFrame() waits
+//   on the fence of the oldest one, so the CPU can't run ahead and input
+//   is read as late as the GPU allows
+// - input-to-present latency: from the first input event a frame picks
+//   up to the swap returning, and to the GPU finishing that frame (the
+//   closest GL gets to the actual flip). the GPU side is seen when the
+//   fence is checked, so it reads up to a frame high unless beginFrame()
+//   had to wait on it
+class FramePacer {
+public:
+    enum VSync { VSYNC_OFF, VSYNC_ON, VSYNC_ADAPTIVE };
+
+    static const int MAX_IN_FLIGHT = 4;
+    static const int LATENCY_SAMPLES = 128;
+
+    VSync vsync = VSYNC_ON;
+    int maxFramesInFlight = 2;      // 1 .. MAX_IN_FLIGHT
+    FrameLimiter limiter;
+
+    // last frame
+    int swapInterval = 1;           // what glfwSwapInterval got
+    float fenceWaitMs = 0.0f;
+
+    // over the last LATENCY_SAMPLES frames that had input, -1 = none yet
+    float swapLatencyP50 = -1.0f, swapLatencyP95 = -1.0f;
+    float gpuLatencyP50 = -1.0f, gpuLatencyP95 = -1.0f;
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+    FramePacer() = default;
+
+    static const char* vsyncName(VSync v) {
+        switch (v) {
+            case VSYNC_OFF: return "off";
+            case VSYNC_ON: return "on";
+            case VSYNC_ADAPTIVE: return "adaptive";
+        }
+        return "?";
+    }
+
+    // current context. render on demand keeps at least vsync on, overlay
+    // frames after input would otherwise run as fast as events come in
+    void applySwapInterval(bool onDemand) {
+        swapInterval = vsync == VSYNC_OFF ? 0 : 1;
+        if (vsync == VSYNC_ADAPTIVE && (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                                        glfwExtensionSupported("GLX_EXT_swap_control_tear"))) {
+            swapInterval = -1;
+        }
+        if (onDemand && swapInterval == 0) swapInterval = 1;
+
+        glfwSwapInterval(swapInterval);
+    }
+
+    // from the GLFW input callbacks
+    void input() {
+        if (!inputPending) {
+            inputPending = true;
+            inputTime = FrameLimiter::Clock::now();
+        }
+    }
+
+    void limit() {
+        limiter.wait();
+    }
+
+    // before the frame's GL work
+    void beginFrame() {
+        collect();
+
+        fenceWaitMs = 0.0f;
+        int limit = std::min(std::max(maxFramesInFlight, 1), MAX_IN_FLIGHT);
+        if (count >= limit) {
+            FrameLimiter::Clock::time_point t0 = FrameLimiter::Clock::now();
+            while (count >= limit) {
+                GLenum r = glClientWaitSync(ring[first].fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+                if (r == GL_WAIT_FAILED) break;
+                if (r != GL_TIMEOUT_EXPIRED) retire();
+            }
+            fenceWaitMs = std::chrono::duration<float, std::milli>(FrameLimiter::Clock::now() - t0).count();
+        }
+
+        frameHasInput = inputPending;
+        frameInput = inputTime;
+        inputPending = false;
+    }
+
+    // right after the swap
+    void presented() {
+        FrameLimiter::Clock::time_point now = FrameLimiter::Clock::now();
+        if (frameHasInput) {
+            push(swapLatency, swapCount, std::chrono::duration<float, std::milli>(now - frameInput).count());
+            percentiles(swapLatency, swapCount, swapLatencyP50, swapLatencyP95);
+        }
+
+        if (count == MAX_IN_FLIGHT) {
+            // beginFrame() was skipped, don't leak the oldest
+            glDeleteSync(ring[first].fence);
+            first = (first + 1) % MAX_IN_FLIGHT;
+            count--;
+        }
+
+        Pending& p = ring[(first + count) % MAX_IN_FLIGHT];
+        p.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        p.hasInput = frameHasInput;
+        p.input = frameInput;
+        count++;
+        frameHasInput = false;
+    }
+
+    // with the context still current
+    void release() {
+        while (count > 0) {
+            glDeleteSync(ring[first].fence);
+            first = (first + 1) % MAX_IN_FLIGHT;
+            count--;
+        }
+    }
+
+private:
+    struct Pending {
+        GLsync fence = 0;
+        bool hasInput = false;
+        FrameLimiter::Clock::time_point input;
+    };
+
+    Pending ring[MAX_IN_FLIGHT];
+    int first = 0, count = 0;
+
+    bool inputPending = false, frameHasInput = false;
+    FrameLimiter::Clock::time_point inputTime, frameInput;
+
+    float swapLatency[LATENCY_SAMPLES] = {};
+    float gpuLatency[LATENCY_SAMPLES] = {};
+    unsigned long long swapCount = 0, gpuCount = 0;
+    float scratch[LATENCY_SAMPLES];
+
+    // frames the GPU already finished, oldest first
+    void collect() {
+        while (count > 0) {
+            GLenum r = glClientWaitSync(ring[first].fence, 0, 0);
+            if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) break;
+            retire();
+        }
+    }
+
+    void retire() {
+        Pending& p = ring[first];
+        if (p.hasInput) {
+            push(gpuLatency, gpuCount, std::chrono::duration<float, std::milli>(FrameLimiter::Clock::now() - p.input).count());
+            percentiles(gpuLatency, gpuCount, gpuLatencyP50, gpuLatencyP95);
+        }
+
+        glDeleteSync(p.fence);
+        p.fence = 0;
+        first = (first + 1) % MAX_IN_FLIGHT;
+        count--;
+    }
+
+    static void push(float* samples, unsigned long long& n, float ms) {
+        samples[n % LATENCY_SAMPLES] = ms;
+        n++;
+    }
+
+    void percentiles(const float* samples, unsigned long long n, float& p50, float& p95) {
+        int size = (int)std::min(n, (unsigned long long)LATENCY_SAMPLES);
+        std::copy(samples, samples + size, scratch);
+        std::sort(scratch, scratch + size);
+        p50 = scratch[size / 2];
+        p95 = scratch[std::min(size - 1, size * 95 / 100)];
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
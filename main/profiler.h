@@ -0,0 +1,386 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TOGL_PROFILE_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TOGL_PROFILE_RDTSC 1
+#endif
+
+#include "imgui/imgui.h"
+
+// markers are on unless built with -DTOGL_PROFILE=0, which turns every
+// PROFILE_SCOPE into nothing
+#ifndef TOGL_PROFILE
+#define TOGL_PROFILE 1
+#endif
+
+// hierarchical CPU profiler. PROFILE_SCOPE("name") records begin/end
+// timestamps (rdtsc where there is one, steady_clock otherwise) into a
+// buffer of the calling thread; nesting comes from the scopes themselves.
+// names must be string literals, only the pointer is kept.
+//
+// the main loop calls endFrame() after present: the frame's events become
+// the flame view of the last frame and, while a capture runs, are kept for
+// the Chrome trace (chrome://tracing, ui.perfetto.dev). whatever was
+// recorded before the first frame (resource setup) is kept as the startup
+// profile once keepStartup() is called.
+class Profiler {
+public:
+    // per thread and frame, past it events are dropped
+    static const size_t MAX_EVENTS = 1 << 16;
+
+    struct Event {
+        const char* name = nullptr;
+        uint64_t begin = 0, end = 0;    // ticks, end = 0 while open
+        int depth = 0;
+    };
+
+    struct ThreadEvents {
+        int tid = 0;
+        std::vector<Event> events;
+    };
+
+    static Profiler& get() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    static uint64_t now() {
+#ifdef TOGL_PROFILE_RDTSC
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // --- recording, any thread ---
+
+    // one per thread. the mutex is only ever contended by collect()
+    struct Buffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        int tid = 0;
+        int depth = 0;
+        unsigned generation = 0;
+        size_t dropped = 0;
+        bool live = true;
+    };
+
+    struct Marker {
+        Buffer* buffer = nullptr;
+        size_t index = 0;
+        unsigned generation = 0;
+    };
+
+    Marker begin(const char* name) {
+        Marker m;
+        m.buffer = threadBuffer();
+
+        std::lock_guard<std::mutex> lock(m.buffer->mutex);
+        m.generation = m.buffer->generation;
+        m.index = m.buffer->events.size();
+        if (m.index == MAX_EVENTS) {
+            m.buffer->dropped++;
+            m.buffer = nullptr;
+            return m;
+        }
+
+        Event e;
+        e.name = name;
+        e.depth = m.buffer->depth++;
+        e.begin = now();
+        m.buffer->events.push_back(e);
+        return m;
+    }
+
+    void end(const Marker& m) {
+        uint64_t t = now();
+        if (!m.buffer) return;
+
+        std::lock_guard<std::mutex> lock(m.buffer->mutex);
+        m.buffer->depth--;
+        // opened before the last endFrame, that event is gone already
+        if (m.generation == m.buffer->generation) m.buffer->events[m.index].end = t;
+    }
+
+    // --- main thread ---
+
+    // the events recorded so far are the startup profile
+    void keepStartup() {
+        startupBegin = epochTicks;
+        startupEnd = frameEnd = now();
+        collect(startup);
+    }
+
+    // after present. true when a capture finished this frame, see
+    // captureResult
+    bool endFrame() {
+        frameBegin = frameEnd;
+        frameEnd = now();
+        collect(lastFrame);
+
+        if (captureLeft == 0) return false;
+
+        for (const ThreadEvents& t : lastFrame) {
+            for (const Event& e : t.events) captured.push_back(std::make_pair(t.tid, e));
+        }
+        if (--captureLeft > 0) return false;
+
+        captureOk = writeTrace(capturePath, captured);
+        captured.clear();
+        captured.shrink_to_fit();
+        return true;
+    }
+
+    // record the next `frames` frames into a Chrome trace at path
+    void capture(int frames, const std::string& path) {
+        captureLeft = frames;
+        capturePath = path;
+        captured.clear();
+    }
+
+    bool capturing() const {
+        return captureLeft > 0;
+    }
+
+    // of the capture endFrame just finished
+    bool captureResult(std::string& path) const {
+        path = capturePath;
+        return captureOk;
+    }
+
+    bool writeStartup(const std::string& path) const {
+        std::vector<std::pair<int, Event>> all;
+        for (const ThreadEvents& t : startup) {
+            for (const Event& e : t.events) all.push_back(std::make_pair(t.tid, e));
+        }
+        return writeTrace(path, all);
+    }
+
+    double ms(uint64_t ticks) const {
+        return ticks / ticksPerMicro() / 1000.0;
+    }
+
+    size_t dropped() const {
+        return droppedLast;
+    }
+
+    // flame graph of the last frame, one block per thread, depth downwards
+    void drawImGui() {
+        drawFlame(lastFrame, frameBegin, frameEnd, "frame");
+        if (!startup.empty() && ImGui::CollapsingHeader("Startup")) drawFlame(startup, startupBegin, startupEnd, "startup");
+    }
+
+private:
+    // releases the buffer when its thread exits, so the short-lived
+    // workers the loaders spawn reuse a handful of buffers
+    struct ThreadSlot {
+        Buffer* buffer = nullptr;
+        ~ThreadSlot() {
+            if (!buffer) return;
+            Profiler& p = Profiler::get();
+            std::lock_guard<std::mutex> lock(p.buffersMutex);
+            buffer->live = false;
+        }
+    };
+
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    std::vector<ThreadEvents> lastFrame, startup;
+    uint64_t frameBegin = 0, frameEnd = 0;
+    uint64_t startupBegin = 0, startupEnd = 0;
+    size_t droppedLast = 0;
+
+    int captureLeft = 0;
+    std::string capturePath;
+    std::vector<std::pair<int, Event>> captured;
+    bool captureOk = false;
+
+    // tick rate, measured against steady_clock since construction
+    uint64_t epochTicks;
+    std::chrono::steady_clock::time_point epochTime;
+
+    Profiler() {
+        epochTicks = now();
+        epochTime = std::chrono::steady_clock::now();
+        frameEnd = epochTicks;
+    }
+
+    Buffer* threadBuffer() {
+        thread_local ThreadSlot slot;
+        if (slot.buffer) return slot.buffer;
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto& b : buffers) {
+            if (b->live) continue;
+            b->live = true;
+            b->depth = 0;
+            slot.buffer = b.get();
+            return slot.buffer;
+        }
+
+        buffers.emplace_back(new Buffer());
+        slot.buffer = buffers.back().get();
+        slot.buffer->tid = (int)buffers.size() - 1;
+        slot.buffer->events.reserve(256);
+        return slot.buffer;
+    }
+
+    // moves the closed events of every thread into out, open ones are dropped
+    void collect(std::vector<ThreadEvents>& out) {
+        size_t used = 0;
+        droppedLast = 0;
+
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto& b : buffers) {
+            std::lock_guard<std::mutex> bufferLock(b->mutex);
+            droppedLast += b->dropped;
+            b->dropped = 0;
+            b->generation++;
+
+            if (!b->events.empty()) {
+                if (out.size() == used) out.emplace_back();
+                ThreadEvents& t = out[used++];
+                t.tid = b->tid;
+                t.events.clear();
+                for (const Event& e : b->events) {
+                    if (e.end) t.events.push_back(e);
+                }
+            }
+            b->events.clear();
+        }
+        out.resize(used);
+    }
+
+    double ticksPerMicro() const {
+#ifdef TOGL_PROFILE_RDTSC
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epochTime).count();
+        return us > 0.0 ? (now() - epochTicks) / us : 1.0;
+#else
+        return 1000.0;
+#endif
+    }
+
+    // chrome trace_event format: complete ("X") events in microseconds
+    bool writeTrace(const std::string& path, const std::vector<std::pair<int, Event>>& events) const {
+        std::ofstream f(path, std::ios::binary);
+        if (!f) return false;
+
+        double rate = ticksPerMicro();
+        std::vector<int> tids;
+        char line[256];
+
+        f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        for (size_t i = 0; i < events.size(); i++) {
+            int tid = events[i].first;
+            const Event& e = events[i].second;
+            if (std::find(tids.begin(), tids.end(), tid) == tids.end()) tids.push_back(tid);
+
+            snprintf(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+                     e.name, tid, (e.begin - epochTicks) / rate, (e.end - e.begin) / rate);
+            f << line;
+        }
+        for (int tid : tids) {
+            snprintf(line, sizeof(line), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}},\n",
+                     tid, tid == 0 ? "main" : "worker", tid);
+            f << line;
+        }
+        f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"togl_demo\"}}\n]}\n";
+        return (bool)f;
+    }
+
+    void drawFlame(const std::vector<ThreadEvents>& threads, uint64_t from, uint64_t to, const char* what) const {
+        if (to <= from) return;
+
+        size_t count = 0;
+        for (const ThreadEvents& t : threads) count += t.events.size();
+        ImGui::Text("%s %.2f ms, %d events, %d threads%s", what, ms(to - from), (int)count, (int)threads.size(),
+                    droppedLast ? " (some dropped)" : "");
+
+        const float ROW = 16.0f;
+        float width = std::max(ImGui::GetContentRegionAvail().x, 360.0f);
+        double span = (double)(to - from);
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+
+        for (const ThreadEvents& t : threads) {
+            int depth = 0;
+            for (const Event& e : t.events) depth = std::max(depth, e.depth + 1);
+
+            ImGui::Text(t.tid == 0 ? "main" : "worker %d", t.tid);
+            ImVec2 origin = ImGui::GetCursorScreenPos();
+            ImGui::Dummy(ImVec2(width, depth * ROW));
+
+            for (const Event& e : t.events) {
+                float x0 = origin.x + (float)((double)(e.begin - std::min(e.begin, from)) / span * width);
+                float x1 = origin.x + (float)((double)(std::min(e.end, to) - std::min(e.begin, from)) / span * width);
+                x1 = std::max(x1, x0 + 1.0f);
+                ImVec2 a(x0, origin.y + e.depth * ROW), b(x1, origin.y + (e.depth + 1) * ROW - 1.0f);
+
+                // hue from the name pointer, the same marker keeps its color
+                unsigned h = (unsigned)((uintptr_t)e.name * 2654435761u) >> 8;
+                dl->AddRectFilled(a, b, IM_COL32(80 + (h & 0x7f), 80 + ((h >> 8) & 0x7f), 120 + ((h >> 16) & 0x5f), 255));
+                if (x1 - x0 > 30.0f) {
+                    dl->PushClipRect(a, b, true);
+                    dl->AddText(ImVec2(x0 + 2.0f, a.y), IM_COL32(0, 0, 0, 255), e.name);
+                    dl->PopClipRect();
+                }
+                if (ImGui::IsMouseHoveringRect(a, b)) ImGui::SetTooltip("%s: %.3f ms", e.name, ms(e.end - e.begin));
+            }
+        }
+    }
+};
+
+// RAII marker, use through PROFILE_SCOPE
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : marker(Profiler::get().begin(name)) {}
+    ~ProfileScope() { Profiler::get().end(marker); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler::Marker marker;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if TOGL_PROFILE
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstring>
+
+// everything the scene image depends on. compared bytewise, so keep it
+// free of padding and pointers
+struct SceneKey {
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    float rotationX = 0.0f;
+    float animTime = 0.0f;
+    int clip = 0;
+    int grid = 0;
+    int msaa = 0;
+    int occlusion = 0;
+    int meshlets = 0;
+    int width = 0, height = 0;
+};
+
+// render-on-demand. the main loop builds a SceneKey every iteration and
+// only draws the scene when it differs from the one last drawn, otherwise
+// the resolved image of that frame is reused and just the overlay goes
+// on top. input wakes the overlay for a few frames; with nothing left to
+// draw the loop blocks on events instead of spinning.
+//
+// changes the key can't see (recreated render targets, the on-demand
+// toggle) call invalidate().
+class RedrawTracker {
+public:
+    // query and hi-z results land up to two frames late, so a change is
+    // drawn a few more times until culling has caught up with it
+    static const int SETTLE_FRAMES = 4;
+
+    // imgui needs a frame or two after an event to settle hover/active state
+    static const int OVERLAY_FRAMES = 3;
+
+    // longest block when idle, the console text still refreshes this often
+    static constexpr double IDLE_TIMEOUT = 0.25;
+
+    bool onDemand = false;
+
+    // since start, for the console
+    unsigned long long sceneFrames = 0, overlayFrames = 0;
+
+    // true if this frame has to draw the scene. always true while off
+    bool needsScene(const SceneKey& key) {
+        if (!onDemand || !valid || memcmp(&key, &drawn, sizeof(SceneKey)) != 0) {
+            drawn = key;
+            valid = true;
+            settle = SETTLE_FRAMES;
+        }
+
+        if (settle > 0) {
+            settle--;
+            sceneFrames++;
+            return true;
+        }
+
+        return false;
+    }
+
+    // true if the overlay alone has to be redrawn, when the scene isn't
+    bool needsOverlay() {
+        if (overlay == 0) return false;
+        overlay--;
+        overlayFrames++;
+        return true;
+    }
+
+    void invalidate() {
+        valid = false;
+    }
+
+    // input arrived, redraw the overlay
+    void wake() {
+        overlay = OVERLAY_FRAMES;
+    }
+
+    // one overlay frame, e.g. to refresh the console after a timeout
+    void refresh() {
+        if (overlay == 0) overlay = 1;
+    }
+
+    // nothing to draw until the next event
+    bool idle() const {
+        return onDemand && valid && settle == 0 && overlay == 0;
+    }
+
+private:
+    SceneKey drawn;
+    bool valid = false;
+    int settle = 0;
+    int overlay = 0;
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,284 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <tiny_gltf.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "workers.h"
+
+// node hierarchy of a glTF scene as flat arrays, one entry per node.
+// nodes are stored in depth-first preorder, so a parent always comes
+// before its children and every subtree is the contiguous index range
+// [i, subtreeEnd[i]). update() only touches the subtrees below dirty
+// nodes: first the local TRS -> matrix pass over the range (independent
+// per node, vectorizes), then the parent * local pass in order.
+class SceneGraph {
+public:
+    // below this many dirty nodes an update stays on the calling thread
+    static const int PARALLEL_MIN_NODES = 8192;
+
+    std::vector<int> parent;            // -1 for roots
+    std::vector<int> subtreeEnd;        // one past the last descendant
+    std::vector<glm::vec3> translation;
+    std::vector<glm::quat> rotation;
+    std::vector<glm::vec3> scale;
+    std::vector<glm::mat4> world;
+    std::vector<unsigned char> dirty;
+    std::vector<int> mesh;              // glTF mesh index or -1
+    std::vector<int> source;            // glTF node index
+    std::vector<std::string> name;
+
+    // stats of the last update()
+    int updatedNodes = 0;
+    int updateJobs = 0;
+
+    int count() const {
+        return (int)parent.size();
+    }
+
+    // appends a node, parent must already be in the graph. building by
+    // hand has to keep the preorder: add a subtree completely before the
+    // next sibling of its root
+    int addNode(int parentIndex, const glm::vec3& t, const glm::quat& r, const glm::vec3& s,
+                int meshIndex = -1, const std::string& nodeName = std::string()) {
+        int i = count();
+        parent.push_back(parentIndex);
+        subtreeEnd.push_back(i + 1);
+        translation.push_back(t);
+        rotation.push_back(r);
+        scale.push_back(s);
+        world.push_back(glm::mat4(1.0f));
+        dirty.push_back(1);
+        mesh.push_back(meshIndex);
+        source.push_back(-1);
+        name.push_back(nodeName);
+        local.emplace_back(1.0f);
+
+        for (int p = parentIndex; p >= 0; p = parent[p]) subtreeEnd[p] = i + 1;
+        return i;
+    }
+
+    void clear() {
+        parent.clear(); subtreeEnd.clear();
+        translation.clear(); rotation.clear(); scale.clear();
+        world.clear(); dirty.clear(); mesh.clear(); source.clear(); name.clear();
+        local.clear();
+    }
+
+    void setLocal(int i, const glm::vec3& t, const glm::quat& r, const glm::vec3& s) {
+        translation[i] = t;
+        rotation[i] = r;
+        scale[i] = s;
+        dirty[i] = 1;
+    }
+
+    void setTranslation(int i, const glm::vec3& t) { translation[i] = t; dirty[i] = 1; }
+    void setRotation(int i, const glm::quat& r)    { rotation[i] = r;    dirty[i] = 1; }
+    void setScale(int i, const glm::vec3& s)       { scale[i] = s;       dirty[i] = 1; }
+
+    // builds from the default scene of the file (or every root node when
+    // the file has no scenes). false if the hierarchy is broken
+    bool build(const tinygltf::Model& m) {
+        clear();
+
+        std::vector<int> roots;
+        if (!m.scenes.empty()) {
+            int s = m.defaultScene >= 0 && m.defaultScene < (int)m.scenes.size() ? m.defaultScene : 0;
+            roots = m.scenes[s].nodes;
+        } else {
+            std::vector<char> isChild(m.nodes.size(), 0);
+            for (const tinygltf::Node& n : m.nodes) {
+                for (int c : n.children) if (c >= 0 && c < (int)m.nodes.size()) isChild[c] = 1;
+            }
+            for (int i = 0; i < (int)m.nodes.size(); i++) if (!isChild[i]) roots.push_back(i);
+        }
+
+        // explicit stack, CAD exports nest deep enough to overflow recursion
+        std::vector<char> visited(m.nodes.size(), 0);
+        std::vector<std::pair<int, int>> stack;     // glTF node, graph parent
+        for (auto it = roots.rbegin(); it != roots.rend(); ++it) stack.push_back({ *it, -1 });
+
+        while (!stack.empty()) {
+            std::pair<int, int> top = stack.back();
+            stack.pop_back();
+
+            int n = top.first;
+            if (n < 0 || n >= (int)m.nodes.size() || visited[n]) {
+                clear();
+                return false;   // out of range, cycle or a node with two parents
+            }
+            visited[n] = 1;
+
+            const tinygltf::Node& node = m.nodes[n];
+            glm::vec3 t(0.0f), s(1.0f);
+            glm::quat r(1.0f, 0.0f, 0.0f, 0.0f);
+            localFromGltf(node, t, r, s);
+
+            int i = addNode(top.second, t, r, s, node.mesh, node.name);
+            source[i] = n;
+
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) stack.push_back({ *it, i });
+        }
+
+        update(1);
+        return true;
+    }
+
+    // recompute world matrices below dirty nodes. threads = 0 uses every
+    // core, big updates are split into whole subtrees across threads
+    void update(int threads = 0) {
+        ranges.clear();
+        updatedNodes = 0;
+
+        const int n = count();
+        const unsigned char* d = dirty.data();
+        for (int i = 0; i < n;) {
+            const void* hit = memchr(d + i, 1, n - i);
+            if (!hit) break;
+
+            i = (int)((const unsigned char*)hit - d);
+            ranges.push_back({ i, subtreeEnd[i] });
+            updatedNodes += subtreeEnd[i] - i;
+            i = subtreeEnd[i];
+        }
+
+        if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        if (threads == 1 || updatedNodes < PARALLEL_MIN_NODES) {
+            for (const Range& r : ranges) updateRange(r.begin, r.end);
+            updateJobs = (int)ranges.size();
+            return;
+        }
+
+        // break big subtrees up: the root is done here, its child subtrees
+        // become jobs of their own. jobs only read parents outside their range
+        int grain = std::max(updatedNodes / (threads * 8), 256);
+        jobs.clear();
+        while (!ranges.empty()) {
+            Range r = ranges.back();
+            ranges.pop_back();
+
+            if (r.end - r.begin <= grain || r.end - r.begin == 1) {
+                jobs.push_back(r);
+                continue;
+            }
+
+            updateRange(r.begin, r.begin + 1);
+            for (int c = r.begin + 1; c < r.end; c = subtreeEnd[c]) ranges.push_back({ c, subtreeEnd[c] });
+        }
+        updateJobs = (int)jobs.size();
+
+        std::atomic<int> next(0);
+        WorkerPool::get().run(std::min(threads, (int)jobs.size()), [this, &next](int) {
+            for (int j = next++; j < (int)jobs.size(); j = next++) updateRange(jobs[j].begin, jobs[j].end);
+        });
+    }
+
+    // first node built from glTF node n, -1 if it isn't in the scene
+    int find(int gltfNode) const {
+        for (int i = 0; i < count(); i++) if (source[i] == gltfNode) return i;
+        return -1;
+    }
+
+    // node transform helpers, also used by the crowd animator
+    static void composeTRS(const glm::vec3& t, const glm::quat& r, const glm::vec3& s, glm::mat4& m) {
+        float x = r.x, y = r.y, z = r.z, w = r.w;
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+
+        m[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f);
+        m[1] = glm::vec4(2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f);
+        m[2] = glm::vec4(2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f);
+        m[3] = glm::vec4(t, 1.0f);
+    }
+
+    // a * b for matrices with a (0,0,0,1) bottom row, which all node
+    // transforms are. 25% less work than a full mat4 product
+    static void mulAffine(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+        const float* A = &a[0][0];
+        const float* B = &b[0][0];
+
+        // load everything first, out may not alias but the compiler can't know
+        float a00 = A[0], a01 = A[1], a02 = A[2];
+        float a10 = A[4], a11 = A[5], a12 = A[6];
+        float a20 = A[8], a21 = A[9], a22 = A[10];
+        float a30 = A[12], a31 = A[13], a32 = A[14];
+
+        float r[16];
+        for (int c = 0; c < 4; c++) {
+            float b0 = B[c * 4], b1 = B[c * 4 + 1], b2 = B[c * 4 + 2];
+            r[c * 4 + 0] = a00 * b0 + a10 * b1 + a20 * b2;
+            r[c * 4 + 1] = a01 * b0 + a11 * b1 + a21 * b2;
+            r[c * 4 + 2] = a02 * b0 + a12 * b1 + a22 * b2;
+            r[c * 4 + 3] = 0.0f;
+        }
+        r[12] += a30;
+        r[13] += a31;
+        r[14] += a32;
+        r[15] = 1.0f;
+
+        memcpy(&out[0][0], r, sizeof(r));
+    }
+
+private:
+    struct Range { int begin, end; };
+
+    std::vector<glm::mat4> local;   // scratch, written by the TRS pass
+    std::vector<Range> ranges;
+    std::vector<Range> jobs;
+
+    void updateRange(int begin, int end) {
+        const glm::vec3* t = translation.data();
+        const glm::quat* r = rotation.data();
+        const glm::vec3* s = scale.data();
+        glm::mat4* l = local.data();
+
+        for (int i = begin; i < end; i++) composeTRS(t[i], r[i], s[i], l[i]);
+
+        const int* p = parent.data();
+        glm::mat4* wm = world.data();
+        for (int i = begin; i < end; i++) {
+            if (p[i] < 0) wm[i] = l[i];
+            else mulAffine(wm[p[i]], l[i], wm[i]);
+        }
+        memset(dirty.data() + begin, 0, end - begin);
+    }
+
+    // glTF gives either TRS or a matrix; matrices are split into TRS so
+    // animation can drive any node. glTF forbids shear, so this is exact
+    static void localFromGltf(const tinygltf::Node& node, glm::vec3& t, glm::quat& r, glm::vec3& s) {
+        if (node.matrix.size() == 16) {
+            glm::mat4 m;
+            for (int c = 0; c < 4; c++) {
+                for (int k = 0; k < 4; k++) m[c][k] = (float)node.matrix[c * 4 + k];
+            }
+
+            t = glm::vec3(m[3]);
+            s = glm::vec3(glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2])));
+            glm::mat3 rot(glm::vec3(m[0]) / s.x, glm::vec3(m[1]) / s.y, glm::vec3(m[2]) / s.z);
+            if (glm::determinant(rot) < 0.0f) {
+                s.x = -s.x;
+                rot[0] = -rot[0];
+            }
+            r = glm::normalize(glm::quat_cast(rot));
+            return;
+        }
+
+        if (node.translation.size() == 3) {
+            t = glm::vec3((float)node.translation[0], (float)node.translation[1], (float)node.translation[2]);
+        }
+        if (node.rotation.size() == 4) {
+            r = glm::quat((float)node.rotation[3], (float)node.rotation[0], (float)node.rotation[1], (float)node.rotation[2]);
+        }
+        if (node.scale.size() == 3) {
+            s = glm::vec3((float)node.scale[0], (float)node.scale[1], (float)node.scale[2]);
+        }
+    }
+};
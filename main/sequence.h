@@ -0,0 +1,306 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+
+#include <stb/stb_image_write.h>
+
+// encoders for --render-seq. frames come in as RGBA8 rows, bottom-up
+// like glReadPixels returns them, and go out as numbered files.
+
+enum class ImageFormat { PNG, EXR, RAW };
+
+inline bool ParseImageFormat(const std::string& s, ImageFormat& out) {
+    if (s == "png") out = ImageFormat::PNG;
+    else if (s == "exr") out = ImageFormat::EXR;
+    else if (s == "raw") out = ImageFormat::RAW;
+    else return false;
+    return true;
+}
+
+inline const char* ImageFormatExt(ImageFormat f) {
+    switch (f) {
+        case ImageFormat::PNG: return "png";
+        case ImageFormat::EXR: return "exr";
+        default: return "rgba";
+    }
+}
+
+// float -> IEEE half, round to nearest, no NaN handling needed here
+inline uint16_t FloatToHalf(float f) {
+    uint32_t x;
+    memcpy(&x, &f, 4);
+
+    uint32_t sign = (x >> 16) & 0x8000;
+    int exp = (int)((x >> 23) & 0xff) - 127 + 15;
+    uint32_t mant = x & 0x7fffff;
+
+    if (exp <= 0) {
+        if (exp < -10) return (uint16_t)sign;
+        mant |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exp);
+        return (uint16_t)(sign | ((mant + (1u << (shift - 1))) >> shift));
+    }
+    if (exp >= 31) return (uint16_t)(sign | 0x7c00);
+
+    uint32_t h = sign | ((uint32_t)exp << 10) | (mant >> 13);
+    if (mant & 0x1000) h++;    // round, may carry into the exponent which is fine
+    return (uint16_t)h;
+}
+
+// uncompressed scanline OpenEXR, half RGBA. the 8-bit sRGB input is
+// converted to linear, which is what EXR readers expect
+inline bool WriteExr(const std::string& path, int w, int h, const unsigned char* rgbaTopDown) {
+    static uint16_t srgbToHalf[256];
+    static uint16_t unormToHalf[256];
+    static bool tables = false;
+    static std::mutex tableMutex;
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        if (!tables) {
+            for (int i = 0; i < 256; i++) {
+                float c = i / 255.0f;
+                float lin = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                srgbToHalf[i] = FloatToHalf(lin);
+                unormToHalf[i] = FloatToHalf(c);
+            }
+            tables = true;
+        }
+    }
+
+    std::vector<unsigned char> out;
+    auto put = [&](const void* p, size_t n) {
+        out.insert(out.end(), (const unsigned char*)p, (const unsigned char*)p + n);
+    };
+    auto putInt = [&](int32_t v) { put(&v, 4); };
+    auto putStr = [&](const char* s) { put(s, strlen(s) + 1); };
+    auto attr = [&](const char* name, const char* type, int32_t size) {
+        putStr(name);
+        putStr(type);
+        putInt(size);
+    };
+
+    const uint32_t magic = 20000630;
+    put(&magic, 4);
+    putInt(2);
+
+    // channels are stored alphabetically
+    const char* channels[4] = { "A", "B", "G", "R" };
+    attr("channels", "chlist", 4 * 18 + 1);
+    for (const char* c : channels) {
+        putStr(c);
+        putInt(1);                      // HALF
+        const unsigned char linear[4] = { 0, 0, 0, 0 };
+        put(linear, 4);                 // pLinear + reserved
+        putInt(1);
+        putInt(1);                      // x/y sampling
+    }
+    out.push_back(0);
+
+    attr("compression", "compression", 1);
+    out.push_back(0);                   // NO_COMPRESSION
+
+    int32_t box[4] = { 0, 0, w - 1, h - 1 };
+    attr("dataWindow", "box2i", 16);
+    put(box, 16);
+    attr("displayWindow", "box2i", 16);
+    put(box, 16);
+
+    attr("lineOrder", "lineOrder", 1);
+    out.push_back(0);                   // INCREASING_Y
+
+    float one = 1.0f, center[2] = { 0.0f, 0.0f };
+    attr("pixelAspectRatio", "float", 4);
+    put(&one, 4);
+    attr("screenWindowCenter", "v2f", 8);
+    put(center, 8);
+    attr("screenWindowWidth", "float", 4);
+    put(&one, 4);
+    out.push_back(0);                   // end of header
+
+    // line offset table, then one block per scanline
+    size_t lineBytes = (size_t)w * 4 * sizeof(uint16_t);
+    uint64_t offset = out.size() + (size_t)h * sizeof(uint64_t);
+    for (int y = 0; y < h; y++) {
+        put(&offset, 8);
+        offset += 8 + lineBytes;
+    }
+
+    std::vector<uint16_t> line((size_t)w * 4);
+    const int source[4] = { 3, 2, 1, 0 };   // A, B, G, R from RGBA
+
+    for (int y = 0; y < h; y++) {
+        const unsigned char* row = rgbaTopDown + (size_t)y * w * 4;
+        for (int c = 0; c < 4; c++) {
+            const uint16_t* lut = c == 0 ? unormToHalf : srgbToHalf;
+            uint16_t* dst = line.data() + (size_t)c * w;
+            for (int x = 0; x < w; x++) dst[x] = lut[row[x * 4 + source[c]]];
+        }
+
+        putInt(y);
+        putInt((int32_t)lineBytes);
+        put(line.data(), lineBytes);
+    }
+
+    std::ofstream f(path, std::ios::binary);
+    if (!f.is_open()) return false;
+    f.write((const char*)out.data(), out.size());
+    return f.good();
+}
+
+// encodes frames on worker threads. submit() copies the frame (flipping it
+// top-down) into a recycled buffer and returns; it only blocks when
+// maxQueued frames are already waiting for a worker.
+class ImageWriterPool {
+public:
+    // stats
+    unsigned long long written = 0;
+    unsigned long long failed = 0;
+    double submitWaitSeconds = 0.0;
+
+    ImageWriterPool(const std::string& dir, ImageFormat format, int w, int h, int threads, int maxQueued)
+        : dir(dir), format(format), width(w), height(h), maxQueued(maxQueued) {
+        for (int i = 0; i < threads; i++) workers.emplace_back([this] { work(); });
+    }
+
+    ~ImageWriterPool() {
+        finish();
+    }
+
+    ImageWriterPool(const ImageWriterPool&) = delete;
+    ImageWriterPool& operator=(const ImageWriterPool&) = delete;
+
+    void submit(unsigned long long frame, const unsigned char* rgbaBottomUp) {
+        std::vector<unsigned char> buf;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if ((int)queue.size() >= maxQueued) {
+                auto t0 = std::chrono::steady_clock::now();
+                spaceFree.wait(lock, [this] { return (int)queue.size() < maxQueued; });
+                submitWaitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            }
+
+            if (!spare.empty()) {
+                buf.swap(spare.back());
+                spare.pop_back();
+            }
+        }
+
+        size_t stride = (size_t)width * 4;
+        buf.resize(stride * height);
+        for (int y = 0; y < height; y++) {
+            memcpy(&buf[(size_t)y * stride], rgbaBottomUp + (size_t)(height - 1 - y) * stride, stride);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(Job{ frame, std::move(buf) });
+        }
+        jobReady.notify_one();
+    }
+
+    // wait for every submitted frame and stop the workers
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+
+        for (std::thread& t : workers) {
+            if (t.joinable()) t.join();
+        }
+        workers.clear();
+    }
+
+    std::string framePath(unsigned long long frame) const {
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%05llu.%s", frame, ImageFormatExt(format));
+        return dir + "/" + name;
+    }
+
+private:
+    struct Job {
+        unsigned long long frame;
+        std::vector<unsigned char> rgba;
+    };
+
+    std::string dir;
+    ImageFormat format;
+    int width, height;
+    int maxQueued;
+
+    std::vector<std::thread> workers;
+    std::deque<Job> queue;
+    std::vector<std::vector<unsigned char>> spare;
+    std::mutex mutex;
+    std::condition_variable jobReady, spaceFree;
+    bool stopping = false;
+
+    void work() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobReady.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            spaceFree.notify_one();
+
+            bool ok = encode(job);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) written++;
+            else failed++;
+            spare.push_back(std::move(job.rgba));
+        }
+    }
+
+    bool encode(const Job& job) const {
+        std::string path = framePath(job.frame);
+
+        switch (format) {
+            case ImageFormat::PNG:
+                return stbi_write_png(path.c_str(), width, height, 4, job.rgba.data(), width * 4) != 0;
+            case ImageFormat::EXR:
+                return WriteExr(path, width, height, job.rgba.data());
+            default: {
+                std::ofstream f(path, std::ios::binary);
+                f.write((const char*)job.rgba.data(), job.rgba.size());
+                return f.good();
+            }
+        }
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
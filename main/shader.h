@@ -7,11 +7,15 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "profiler.h"
+
 class Shader {
 public:
     unsigned int ID;
 
     Shader(const char* vertexPath, const char* fragmentPath) {
+        PROFILE_SCOPE("Shader");
+
         std::string vCode, fCode;
 
         std::ifstream vFile(vertexPath);
@@ -51,20 +55,27 @@ public:
         glUseProgram(ID);
     }
 
-    void setInt(const std::string &name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    // names are C strings, a std::string temporary per call would be a
+    // heap allocation per uniform per frame
+    void setInt(const char* name, int value) const {
+        glUniform1i(glGetUniformLocation(ID, name), value);
+    }
+
+    void setFloat(const char* name, float value) const {
+        glUniform1f(glGetUniformLocation(ID, name), value);
     }
 
-    void setFloat(const std::string &name, float value) const {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    void setVec3(const char* name, const glm::vec3 &value) const {
+        glUniform3fv(glGetUniformLocation(ID, name), 1, &value[0]);
     }
 
-    void setVec3(const std::string &name, const glm::vec3 &value) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    void setMat4(const char* name, const glm::mat4 &mat) const {
+        glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, &mat[0][0]);
     }
 
-    void setMat4(const std::string &name, const glm::mat4 &mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    void setBlockBinding(const char* name, unsigned int binding) const {
+        unsigned int index = glGetUniformBlockIndex(ID, name);
+        if (index != GL_INVALID_INDEX) glUniformBlockBinding(ID, index, binding);
     }
 
 private:
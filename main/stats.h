@@ -0,0 +1,222 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cfloat>
+
+#include "imgui/imgui.h"
+#include "log.h"
+
+// rolling frame statistics: ring of the last CAPACITY frames with the
+// CPU frame interval, the GPU time (filled in late, when the timer query
+// lands) and whatever was noted during the frame. frames slower than
+// stutterFactor x median are logged together with those notes.
+class FrameStats {
+public:
+    static const int CAPACITY = 1024;
+
+    struct Sample {
+        unsigned long long frame = 0;
+        double time = 0.0;      // seconds since start
+        float cpuMs = 0.0f;
+        float gpuMs = -1.0f;    // < 0 until the GPU result arrives
+        std::string events;
+    };
+
+    // rolling percentiles over the ring, updated every tick()
+    float p50 = 0.0f, p95 = 0.0f, p99 = 0.0f, maxMs = 0.0f;
+    float gpuP50 = -1.0f;
+
+    float stutterFactor = 2.5f;
+    unsigned long long stutters = 0;
+
+    FrameStats() {
+        samples.resize(CAPACITY);
+        sorted.reserve(CAPACITY);
+        plot.resize(CAPACITY);
+        start = last = std::chrono::steady_clock::now();
+    }
+
+    // call right before the first frame so load time doesn't count as one
+    void restartClock() {
+        start = last = std::chrono::steady_clock::now();
+    }
+
+    // after blocking on events: the wait isn't part of the next frame
+    void skipWait() {
+        last = std::chrono::steady_clock::now();
+    }
+
+    // something that may explain a slow frame (command, reload, ...)
+    void note(std::string_view what) {
+        if (!pending.empty()) pending += "; ";
+        pending.append(what.data(), what.size());
+    }
+
+    // once per frame, after present. the interval since the previous tick
+    // is this frame's CPU time
+    void tick() {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        float ms = std::chrono::duration<float, std::milli>(now - last).count();
+        last = now;
+
+        Sample& s = samples[head];
+        s.frame = frame;
+        s.time = std::chrono::duration<double>(now - start).count();
+        s.cpuMs = ms;
+        s.gpuMs = -1.0f;
+        s.events.swap(pending);
+        pending.clear();
+
+        // against the median before this frame got in
+        if (count >= WARMUP_FRAMES && p50 > 0.0f && ms > stutterFactor * p50) {
+            stutters++;
+
+            LogWarningf("stutter: frame %llu took %.2f ms (%.1fx median %.2f ms), during: %s",
+                        frame, ms, ms / p50, p50, s.events.empty() ? "nothing noted" : s.events.c_str());
+        }
+
+        head = (head + 1) % CAPACITY;
+        if (count < CAPACITY) count++;
+        frame++;
+
+        updatePercentiles();
+    }
+
+    // GPU time of an earlier frame, dropped if it already left the ring
+    void setGpu(unsigned long long f, float ms) {
+        if (f >= frame || frame - f > (unsigned long long)count) return;
+
+        Sample& s = samples[(head + CAPACITY - (int)(frame - f)) % CAPACITY];
+        if (s.frame == f) s.gpuMs = ms;
+    }
+
+    unsigned long long frameIndex() const {
+        return frame;
+    }
+
+    void reset() {
+        head = count = 0;
+        p50 = p95 = p99 = maxMs = 0.0f;
+        gpuP50 = -1.0f;
+        stutters = 0;
+    }
+
+    bool dumpCsv(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) return false;
+
+        out << "frame,time_s,cpu_ms,gpu_ms,events\n";
+        for (int i = 0; i < count; i++) {
+            const Sample& s = at(i);
+            out << s.frame << "," << s.time << "," << s.cpuMs << ",";
+            if (s.gpuMs >= 0.0f) out << s.gpuMs;
+
+            // csv quoting, events may contain commas
+            std::string e = s.events;
+            for (size_t p = e.find('"'); p != std::string::npos; p = e.find('"', p + 2)) e.insert(p, "\"");
+            out << ",\"" << e << "\"\n";
+        }
+        return true;
+    }
+
+    // graph + histogram, inside an open ImGui window
+    void drawImGui() {
+        if (count == 0) return;
+
+        for (int i = 0; i < count; i++) plot[i] = at(i).cpuMs;
+
+        float top = std::max(maxMs, 1.0f);
+        char overlay[96];
+        snprintf(overlay, sizeof(overlay), "p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", p50, p95, p99, maxMs);
+        ImGui::PlotLines("cpu ms", plot.data(), count, 0, overlay, 0.0f, top, ImVec2(360, 70));
+
+        int gpuCount = 0;
+        for (int i = 0; i < count; i++) {
+            float g = at(i).gpuMs;
+            if (g >= 0.0f) plot[gpuCount++] = g;
+        }
+        if (gpuCount) {
+            snprintf(overlay, sizeof(overlay), "p50 %.2f ms", gpuP50);
+            ImGui::PlotLines("gpu ms", plot.data(), gpuCount, 0, overlay, 0.0f, top, ImVec2(360, 50));
+        }
+
+        // histogram over 0 .. 2 x p99
+        const int BINS = 32;
+        float bins[BINS] = {};
+        float range = std::max(p99 * 2.0f, 1.0f);
+        for (int i = 0; i < count; i++) {
+            int b = (int)(at(i).cpuMs / range * BINS);
+            bins[std::min(std::max(b, 0), BINS - 1)] += 1.0f;
+        }
+
+        snprintf(overlay, sizeof(overlay), "0 .. %.1f ms", range);
+        ImGui::PlotHistogram("histogram", bins, BINS, 0, overlay, 0.0f, FLT_MAX, ImVec2(360, 60));
+        ImGui::Text("stutters (> %.1fx median): %llu", stutterFactor, stutters);
+    }
+
+private:
+    static const int WARMUP_FRAMES = 30;
+
+    std::vector<Sample> samples;
+    std::vector<float> sorted;
+    std::vector<float> plot;
+    std::string pending;
+    int head = 0;
+    int count = 0;
+    unsigned long long frame = 0;
+    std::chrono::steady_clock::time_point start, last;
+
+    // i = 0 is the oldest frame in the ring
+    const Sample& at(int i) const {
+        return samples[(head + CAPACITY - count + i) % CAPACITY];
+    }
+
+    static float percentile(const std::vector<float>& v, float p) {
+        return v[(size_t)(p * (v.size() - 1) + 0.5f)];
+    }
+
+    void updatePercentiles() {
+        sorted.clear();
+        for (int i = 0; i < count; i++) sorted.push_back(at(i).cpuMs);
+        std::sort(sorted.begin(), sorted.end());
+
+        p50 = percentile(sorted, 0.50f);
+        p95 = percentile(sorted, 0.95f);
+        p99 = percentile(sorted, 0.99f);
+        maxMs = sorted.back();
+
+        sorted.clear();
+        for (int i = 0; i < count; i++) {
+            if (at(i).gpuMs >= 0.0f) sorted.push_back(at(i).gpuMs);
+        }
+        if (!sorted.empty()) {
+            std::sort(sorted.begin(), sorted.end());
+            gpuP50 = percentile(sorted, 0.50f);
+        }
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
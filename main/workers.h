@@ -0,0 +1,139 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+// persistent worker threads for the per-frame parallel passes (scene
+// graph, crowd animation, meshlet culling). starting std::threads every
+// frame costs a heap allocation each, these start once on first use.
+//
+// run(tasks, fn) calls fn(0) .. fn(tasks - 1) spread over the workers and
+// the calling thread, and returns when all are done. one batch at a time;
+// a call from inside a task runs inline
+class WorkerPool {
+public:
+    static WorkerPool& get() {
+        static WorkerPool pool((int)std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    explicit WorkerPool(int workers) : workerCount(std::max(0, workers)) {}
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+
+    // worker threads, the caller makes one more
+    int size() const { return workerCount; }
+
+    template <typename F>
+    void run(int tasks, F&& fn) {
+        using Fn = typename std::remove_reference<F>::type;
+        runBatch(tasks, [](void* ctx, int i) { (*(Fn*)ctx)(i); }, (void*)&fn);
+    }
+
+private:
+    typedef void (*TaskFn)(void*, int);
+
+    int workerCount;
+    std::vector<std::thread> threads;
+
+    std::mutex batchMutex;              // one batch at a time
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    TaskFn fn = nullptr;
+    void* ctx = nullptr;
+    int tasks = 0;
+    std::atomic<int> next{0};
+    int busy = 0;                       // workers still in the current batch
+    unsigned long long batch = 0;
+    bool quit = false;
+
+    static bool& insideTask() {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    void runBatch(int count, TaskFn f, void* c) {
+        if (count <= 1 || workerCount == 0 || insideTask()) {
+            for (int i = 0; i < count; i++) f(c, i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> batchLock(batchMutex);
+        if (threads.empty()) {
+            for (int i = 0; i < workerCount; i++) threads.emplace_back([this] { loop(); });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fn = f;
+            ctx = c;
+            tasks = count;
+            next = 0;
+            busy = workerCount;
+            batch++;
+        }
+        wake.notify_all();
+
+        insideTask() = true;
+        work();
+        insideTask() = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+    }
+
+    void work() {
+        for (int i = next++; i < tasks; i = next++) fn(ctx, i);
+    }
+
+    void loop() {
+        insideTask() = true;
+        unsigned long long seen = 0;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return quit || batch != seen; });
+            if (quit) return;
+            seen = batch;
+
+            lock.unlock();
+            work();
+            lock.lock();
+
+            if (--busy == 0) done.notify_one();
+        }
+    }
+};
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 330 core
+
+// depth-only pass, must produce the exact same positions as phong.vert
+layout (location = 0) in vec3 inPos;
+layout (location = 3) in mat4 inModel;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 viewPos;
+};
+
+invariant gl_Position;
+
+void main()
+{
+    vec3 worldPos = vec3(inModel * vec4(inPos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
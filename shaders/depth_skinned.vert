@@ -0,0 +1,39 @@
+#version 330 core
+
+// depth-only pass for skinned meshes, must match phong_skinned.vert
+layout (location = 0) in vec3 inPos;
+layout (location = 3) in mat4 inModel;
+layout (location = 7) in uvec4 inJoints;
+layout (location = 8) in vec4 inWeights;
+layout (location = 9) in int inPalette;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 viewPos;
+};
+
+uniform samplerBuffer bonePalette;
+
+invariant gl_Position;
+
+mat4 bone(uint joint)
+{
+    int t = inPalette + int(joint) * 3;
+    return transpose(mat4(texelFetch(bonePalette, t),
+                          texelFetch(bonePalette, t + 1),
+                          texelFetch(bonePalette, t + 2),
+                          vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+void main()
+{
+    mat4 skin = inWeights.x * bone(inJoints.x) + inWeights.y * bone(inJoints.y) +
+                inWeights.z * bone(inJoints.z) + inWeights.w * bone(inJoints.w);
+    mat4 model = inModel * skin;
+
+    vec3 worldPos = vec3(model * vec4(inPos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
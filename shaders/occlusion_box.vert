@@ -0,0 +1,21 @@
+#version 330 core
+
+// unit cube (0..1) stretched over a world space bounding box
+layout (location = 0) in vec3 inPos;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 viewPos;
+};
+
+uniform vec3 boxMin;
+uniform vec3 boxMax;
+
+void main()
+{
+    vec3 worldPos = mix(boxMin, boxMax, inPos);
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
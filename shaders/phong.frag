@@ -5,33 +5,133 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 UV;
+flat in uint Material;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;    // w = ambient strength
+    vec4 viewPos;
+};
+
+// one entry per glTF material, MaterialUniforms in material.h
+struct MaterialEntry {
+    vec4 baseColor;
+    vec4 factors;           // metallic, roughness, normal scale, alpha cutoff
+    ivec4 baseAndNormal;    // pool + layer of the base color and normal map, -1 = none
+    ivec4 metalRough;       // pool, layer, wrap bits, double sided
+};
+
+layout (std140) uniform Materials {
+    MaterialEntry materials[256];
+};
+
+// texture array pools, every texture is a (pool, layer) pair
+uniform sampler2DArray pools[8];
+uniform samplerCube environment;
+
+// taken before any branch, the pool switch isn't uniform control flow
+vec2 uvDx, uvDy;
+
+// sampler arrays only take constant indices in GLSL 3.30
+vec4 samplePool(int pool, vec3 uvLayer)
+{
+    switch (pool) {
+        case 0: return textureGrad(pools[0], uvLayer, uvDx, uvDy);
+        case 1: return textureGrad(pools[1], uvLayer, uvDx, uvDy);
+        case 2: return textureGrad(pools[2], uvLayer, uvDx, uvDy);
+        case 3: return textureGrad(pools[3], uvLayer, uvDx, uvDy);
+        case 4: return textureGrad(pools[4], uvLayer, uvDx, uvDy);
+        case 5: return textureGrad(pools[5], uvLayer, uvDx, uvDy);
+        case 6: return textureGrad(pools[6], uvLayer, uvDx, uvDy);
+        case 7: return textureGrad(pools[7], uvLayer, uvDx, uvDy);
+    }
+    return vec4(1.0);
+}
+
+// the pools repeat, clamp and mirror are done here per texture
+float wrapCoord(float t, int mode)
+{
+    if (mode == 1) return clamp(t, 0.0, 1.0);
+    if (mode == 2) {
+        float m = mod(t, 2.0);
+        return m > 1.0 ? 2.0 - m : m;
+    }
+    return t;
+}
+
+vec4 sampleTexture(int pool, int layer, int wrap)
+{
+    if (pool < 0) return vec4(1.0);
+
+    vec2 uv = vec2(wrapCoord(UV.x, wrap & 3), wrapCoord(UV.y, (wrap >> 2) & 3));
+    return samplePool(pool, vec3(uv, float(layer)));
+}
+
+vec3 srgbToLinear(vec3 c) { return pow(c, vec3(2.2)); }
+vec3 linearToSrgb(vec3 c) { return pow(c, vec3(1.0 / 2.2)); }
 
 void main()
 {
-    vec3 color = vec3(0.2, 1.0, 0.3);   // green
+    uvDx = dFdx(UV);
+    uvDy = dFdy(UV);
+    vec3 posDx = dFdx(FragPos);
+    vec3 posDy = dFdy(FragPos);
+
+    MaterialEntry m = materials[Material];
+    int wrap = m.metalRough.z;
 
-    // ambient
-    float ambientStrength = 0.15;
-    vec3 ambient = ambientStrength * color;
+    vec4 base = m.baseColor * sampleTexture(m.baseAndNormal.x, m.baseAndNormal.y, wrap);
+    if (m.factors.w > 0.0 && base.a < m.factors.w) discard;
 
-    // diffuse
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    if (m.metalRough.w != 0 && !gl_FrontFacing) norm = -norm;
+
+    // no tangents in the vertex format, the frame comes from screen space
+    // derivatives (as in the glTF sample viewer)
+    if (m.baseAndNormal.z >= 0) {
+        float det = uvDx.x * uvDy.y - uvDy.x * uvDx.y;
+        if (abs(det) > 1e-12) {
+            vec3 t = (uvDy.y * posDx - uvDx.y * posDy) / det;
+            t = normalize(t - norm * dot(norm, t));
+            vec3 b = cross(norm, t);
+
+            vec3 n = sampleTexture(m.baseAndNormal.z, m.baseAndNormal.w, wrap >> 4).xyz * 2.0 - 1.0;
+            n.xy *= m.factors.z;
+            norm = normalize(mat3(t, b, norm) * n);
+        }
+    }
+
+    float metallic = m.factors.x;
+    float roughness = m.factors.y;
+    if (m.metalRough.x >= 0) {
+        vec4 mr = sampleTexture(m.metalRough.x, m.metalRough.y, wrap >> 8);
+        roughness *= mr.g;      // glTF: green = roughness, blue = metallic
+        metallic *= mr.b;
+    }
+    roughness = clamp(roughness, 0.04, 1.0);
+
+    // phong fed with metal-rough inputs: metals have no diffuse and a
+    // tinted highlight, roughness sets the highlight width
+    vec3 diffuseColor = base.rgb * (1.0 - metallic);
+    vec3 f0 = mix(vec3(0.04), base.rgb, metallic);
+    vec3 ambient = lightColor.rgb * lightColor.w;
+
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
+    vec3 halfDir = normalize(lightDir + viewDir);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * color;
 
-    // specular
-    float specStrength = 0.5;
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
+    // blinn-phong exponent matching the GGX alpha, roughly normalized
+    float a = roughness * roughness;
+    float shininess = clamp(2.0 / (a * a) - 2.0, 1.0, 2048.0);
+    float spec = pow(max(dot(norm, halfDir), 0.0), shininess) * (shininess + 8.0) / 25.0 * diff;
 
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 16);
-    vec3 specular = specStrength * spec * vec3(1.0);
+    // smooth surfaces mirror the skybox, rough ones only see the ambient
+    vec3 env = mix(srgbToLinear(texture(environment, reflect(-viewDir, norm)).rgb), ambient, roughness);
 
-    vec3 result = ambient + diffuse + specular;
+    vec3 result = (ambient + diff * lightColor.rgb) * diffuseColor + spec * lightColor.rgb * f0 + env * f0;
 
-    FragColor = vec4(result, 1.0);
+    FragColor = vec4(linearToSrgb(result), 1.0);
 }
@@ -3,19 +3,30 @@
 layout (location = 0) in vec3 inPos;
 layout (location = 1) in vec3 inNormal;
 layout (location = 2) in vec2 inUV;
+layout (location = 3) in mat4 inModel;  // per instance, streamed
+layout (location = 10) in uint inMaterial;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 UV;
+flat out uint Material;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;    // w = ambient strength
+    vec4 viewPos;
+};
+
+// depth.vert writes the same positions for the pre-pass
+invariant gl_Position;
 
 void main()
 {
-    FragPos = vec3(model * vec4(inPos, 1.0));
-    Normal  = mat3(transpose(inverse(model))) * inNormal;
+    FragPos = vec3(inModel * vec4(inPos, 1.0));
+    Normal  = mat3(transpose(inverse(inModel))) * inNormal;
     UV      = inUV;
+    Material = inMaterial;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -0,0 +1,52 @@
+#version 330 core
+
+// phong.vert with linear blend skinning. bone palettes of all instances
+// live in one texture buffer, 3 texels (rows of a 3x4 matrix) per joint
+layout (location = 0) in vec3 inPos;
+layout (location = 1) in vec3 inNormal;
+layout (location = 2) in vec2 inUV;
+layout (location = 3) in mat4 inModel;  // per instance, streamed
+layout (location = 7) in uvec4 inJoints;
+layout (location = 8) in vec4 inWeights;
+layout (location = 9) in int inPalette; // per instance, first texel of its palette
+layout (location = 10) in uint inMaterial;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 UV;
+flat out uint Material;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;    // w = ambient strength
+    vec4 viewPos;
+};
+
+uniform samplerBuffer bonePalette;
+
+// depth_skinned.vert writes the same positions for the pre-pass
+invariant gl_Position;
+
+mat4 bone(uint joint)
+{
+    int t = inPalette + int(joint) * 3;
+    return transpose(mat4(texelFetch(bonePalette, t),
+                          texelFetch(bonePalette, t + 1),
+                          texelFetch(bonePalette, t + 2),
+                          vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+void main()
+{
+    mat4 skin = inWeights.x * bone(inJoints.x) + inWeights.y * bone(inJoints.y) +
+                inWeights.z * bone(inJoints.z) + inWeights.w * bone(inJoints.w);
+    mat4 model = inModel * skin;
+
+    FragPos = vec3(model * vec4(inPos, 1.0));
+    Normal  = mat3(transpose(inverse(model))) * inNormal;
+    UV      = inUV;
+    Material = inMaterial;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
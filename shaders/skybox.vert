@@ -5,10 +5,11 @@ out vec3 TexCoords;
 
 uniform mat4 view;
 uniform mat4 projection;
+uniform float farDepth;     // clip z / w of the far plane, Camera::farClipDepth
 
 void main()
 {
     vec4 pos = projection * view * vec4(inPos, 1.0);
-    gl_Position = pos.xyww; // depth = 1.0
+    gl_Position = vec4(pos.xy, farDepth * pos.w, pos.w);    // on the far plane
     TexCoords = inPos;
 }
@@ -0,0 +1,186 @@
+// togl_replay: replays a GL trace captured with `togl_demo --capture`
+// in a tight loop on an offscreen context and reports per-call and
+// per-frame timings.
+//
+// usage: togl_replay <trace.trc> [loops]
+
+#include <glad/glad.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#include "render/Offscreen.h"
+#include "render/GLTrace.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct CallStats {
+    unsigned long long calls = 0;
+    double seconds = 0.0;
+};
+
+static double Seconds(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+// stands in for the window's framebuffer
+static GLuint CreateDefaultFramebuffer(int w, int h, GLuint* color, GLuint* depth) {
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenRenderbuffers(1, color);
+    glBindRenderbuffer(GL_RENDERBUFFER, *color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, *color);
+
+    glGenRenderbuffers(1, depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, *depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, *depth);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "replay framebuffer incomplete!" << std::endl;
+    }
+
+    glViewport(0, 0, w, h);
+    return fbo;
+}
+
+static double Percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+    return v[i];
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "usage: togl_replay <trace.trc> [loops]\n";
+        return 1;
+    }
+
+    std::string path = argv[1];
+    int loops = argc > 2 ? std::max(1, atoi(argv[2])) : 100;
+
+    GLTracePlayer player;
+    if (!player.load(path)) return 1;
+
+    if (player.frames.empty()) {
+        std::cerr << "trace has no complete frames" << std::endl;
+        return 1;
+    }
+
+    OffscreenContext ctx;
+    if (!ctx.create()) return 1;
+
+    std::cout << "OpenGL: " << glGetString(GL_VERSION) << "\n";
+    std::cout << "GPU: " << glGetString(GL_RENDERER) << "\n";
+    std::cout << "trace: " << path << ", " << player.width << "x" << player.height << ", "
+              << player.setup.size() << " setup calls, " << player.frames.size() << " frame(s)\n";
+
+    GLuint color = 0, depth = 0;
+    player.defaultFramebuffer = CreateDefaultFramebuffer(player.width, player.height, &color, &depth);
+
+    // resource setup runs once and is reported separately
+    Clock::time_point t0 = Clock::now();
+    for (const GLTracePlayer::Record& r : player.setup) player.execute(r);
+    glFinish();
+    double setupTime = Seconds(t0, Clock::now());
+
+    std::vector<CallStats> calls(gltrace::OP_COUNT);
+    std::vector<double> frameTimes;
+    frameTimes.reserve(loops * player.frames.size());
+
+    Clock::time_point runStart = Clock::now();
+
+    for (int loop = 0; loop < loops; loop++) {
+        for (const std::vector<GLTracePlayer::Record>& frame : player.frames) {
+            Clock::time_point frameStart = Clock::now();
+
+            for (const GLTracePlayer::Record& r : frame) {
+                Clock::time_point c0 = Clock::now();
+                player.execute(r);
+                Clock::time_point c1 = Clock::now();
+
+                calls[r.op].calls++;
+                calls[r.op].seconds += Seconds(c0, c1);
+            }
+
+            // include the GPU work, not just submission
+            glFinish();
+            frameTimes.push_back(Seconds(frameStart, Clock::now()));
+        }
+    }
+
+    double total = Seconds(runStart, Clock::now());
+    GLenum err = glGetError();
+
+    double sum = 0.0;
+    for (double f : frameTimes) sum += f;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\nsetup: " << setupTime * 1000.0 << " ms\n";
+    std::cout << "frames: " << frameTimes.size() << " in " << total << " s ("
+              << frameTimes.size() / total << " fps)\n";
+    std::cout << "frame ms: avg " << sum / frameTimes.size() * 1000.0
+              << "  min " << Percentile(frameTimes, 0.0) * 1000.0
+              << "  p50 " << Percentile(frameTimes, 0.5) * 1000.0
+              << "  p95 " << Percentile(frameTimes, 0.95) * 1000.0
+              << "  max " << Percentile(frameTimes, 1.0) * 1000.0 << "\n\n";
+
+    std::vector<int> order;
+    for (int op = 0; op < gltrace::OP_COUNT; op++) {
+        if (calls[op].calls) order.push_back(op);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return calls[a].seconds > calls[b].seconds;
+    });
+
+    std::cout << std::left << std::setw(34) << "call" << std::right
+              << std::setw(12) << "calls/frame" << std::setw(14) << "total ms"
+              << std::setw(12) << "avg us" << "\n";
+
+    for (int op : order) {
+        const CallStats& c = calls[op];
+        std::cout << std::left << std::setw(34) << gltrace::opName(op) << std::right
+                  << std::setw(12) << (double)c.calls / frameTimes.size()
+                  << std::setw(14) << c.seconds * 1000.0
+                  << std::setw(12) << c.seconds / c.calls * 1e6 << "\n";
+    }
+
+    if (err != GL_NO_ERROR) {
+        std::cerr << "GL error during replay: 0x" << std::hex << err << std::endl;
+    }
+
+    glDeleteRenderbuffers(1, &color);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &player.defaultFramebuffer);
+
+    return err == GL_NO_ERROR ? 0 : 2;
+}
+
+/*  
+
+Author: theurg1st  
+Website: https://theurg1st.github.io
+
+========================================
+License
+========================================
+
+This project is released under the MIT License.  
+You may use, modify, or redistribute the source code with attribution.
+
+========================================
+Credits
+========================================
+
+Made by theurg1st
+
+*/
\ No newline at end of file